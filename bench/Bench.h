@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+/**
+ * Minimal harness for ForgottenMagicBench
+ *
+ * Each benchmark is a function defined with FORGOTTEN_MAGIC_BENCHMARK, which registers it
+ * under its name; it measures whatever it likes and prints its results with Report. main
+ * runs every benchmark whose name contains one of the command line filters.
+ */
+namespace ForgottenMagic::Bench {
+    using Clock = std::chrono::steady_clock;
+
+    struct Benchmark {
+        const char* name;
+        void (*run)();
+    };
+
+    inline std::vector<Benchmark>& Registry() {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    struct Registration {
+        Registration(const char* name, void (*run)()) { Registry().push_back({name, run}); }
+    };
+
+    // Prints one named result of the running benchmark
+    inline void Report(std::string_view metric, double value, std::string_view unit) {
+        std::printf("    %-56.*s %16.2f %.*s\n", static_cast<int>(metric.size()), metric.data(), value, static_cast<int>(unit.size()), unit.data());
+    }
+
+    // Value below which the given fraction of samples fall (reorders the samples)
+    inline double Percentile(std::vector<double>& samples, double fraction) {
+        if (samples.empty()) return 0.0;
+        const auto rank = std::min(samples.size() - 1, static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1) + 0.5));
+        std::ranges::nth_element(samples, samples.begin() + static_cast<std::ptrdiff_t>(rank));
+        return samples[rank];
+    }
+
+    template <typename Duration>
+    double Nanoseconds(Duration duration) {
+        return std::chrono::duration<double, std::nano>(duration).count();
+    }
+    template <typename Duration>
+    double Microseconds(Duration duration) {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    }
+    template <typename Duration>
+    double Seconds(Duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    // Bytes currently allocated through operator new, counted by main.cpp's replacement of it
+    std::size_t AllocatedBytes();
+
+    // Keeps a computed value alive so the work producing it is not optimized away
+    inline volatile std::uint64_t sink = 0;
+
+    inline void Consume(std::uint64_t value) { sink = sink + value; }
+}
+
+#define FORGOTTEN_MAGIC_BENCHMARK(name)                                                \
+    static void name();                                                                \
+    static const ::ForgottenMagic::Bench::Registration name##Registration(#name, name); \
+    static void name()
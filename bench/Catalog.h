@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ForgottenMagic/InMemory.h>
+#include <ForgottenMagic/Interfaces.h>
+#include <ForgottenMagic/SpellNameRenderer.h>
+#include <ForgottenMagic/SpellNameUpdater.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ForgottenMagic::Bench {
+
+    // Number of spells in the shipped INI's [SpellIndexes]
+    constexpr std::size_t FORGOTTEN_MAGIC_SPELL_COUNT = 41;
+
+    /**
+     * Registry columns and XP table of a synthetic catalog, as the plugin lays them out
+     *
+     * Spell handle i has spell index i and a name about as long as Forgotten Magic's.
+     */
+    struct SyntheticCatalog {
+        std::vector<SpellIndex>        spellIndexes;
+        std::vector<std::string>       originalNames;
+        std::vector<SpellNameRenderer> nameRenderers;
+        InMemoryXpSource               xpSource;
+
+        explicit SyntheticCatalog(std::size_t spellCount) : spellIndexes(spellCount), originalNames(spellCount), nameRenderers(spellCount) {
+            xpSource.entries.assign(spellCount, {0.0f, 100.0f, 0});
+            for (std::size_t i = 0; i < spellCount; i++) {
+                spellIndexes[i]  = static_cast<SpellIndex>(i);
+                originalNames[i] = "Forgotten Spell " + std::to_string(i);
+                nameRenderers[i].Reserve(originalNames[i]);
+            }
+        }
+
+        std::size_t Size() const { return spellIndexes.size(); }
+
+        SpellNameColumns Columns() { return {spellIndexes, originalNames, nameRenderers}; }
+
+        // Moves every spell to another percentage, so the next batch renames all of them
+        void Advance(std::uint32_t step) {
+            for (auto& entry : xpSource.entries) {
+                entry.xp     = static_cast<float>(step % 100);
+                entry.points = static_cast<std::int32_t>(step / 100 % 4);
+            }
+        }
+    };
+}
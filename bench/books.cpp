@@ -0,0 +1,106 @@
+// Startup cost of matching spell books to configured spells over a synthetic load order of
+// 100k books: the SpellRegistry's book-name index against the per-book linear scan it replaced
+
+#include <ForgottenMagic/SpellRegistry.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    constexpr std::size_t   BOOK_COUNT     = 100'000;
+    constexpr std::uint32_t TRACKED_PLUGIN = 0x2A00'0000;
+
+    struct Book {
+        std::uint32_t formID;
+        bool          teachesSpell;
+        std::string   fullName;
+    };
+
+    std::string BookName(std::size_t spell) { return "Spell Tome: Forgotten Spell " + std::to_string(spell); }
+
+    /**
+     * @param trackedBookCount How many books come from the progression mod; the first 41 teach its configured spells
+     */
+    std::vector<Book> BuildLoadOrder(std::size_t trackedBookCount) {
+        std::mt19937                                 random(3);
+        std::uniform_int_distribution<std::uint32_t> plugins(0, 0xFD);
+        std::vector<Book>                            books;
+        books.reserve(BOOK_COUNT);
+        for (std::size_t i = 0; i < BOOK_COUNT; i++) {
+            const auto tracked = i % (BOOK_COUNT / trackedBookCount) == 0;
+            const auto index   = i / (BOOK_COUNT / trackedBookCount);
+            const auto plugin  = tracked ? TRACKED_PLUGIN : plugins(random) << 24;
+            auto       name    = tracked && index < FORGOTTEN_MAGIC_SPELL_COUNT ? BookName(index) : "Spell Tome: Some Other Spell " + std::to_string(i);
+            books.push_back({plugin | static_cast<std::uint32_t>(0x800 + i), true, std::move(name)});
+        }
+        return books;
+    }
+
+    // Returns the number of books matched and the time the scan took, as LoadForgottenMagicSpellsData matches them
+    std::pair<std::size_t, double> MatchHashed(const std::vector<const Book*>& books) {
+        struct SpellForm {};
+        std::vector<SpellDefinition> definitions;
+        for (std::size_t spell = 0; spell < FORGOTTEN_MAGIC_SPELL_COUNT; spell++) definitions.push_back({0, static_cast<SpellIndex>(spell), BookName(spell)});
+        SpellRegistry<SpellForm> registry;
+        registry.Configure(std::move(definitions));
+
+        std::size_t found     = 0;
+        const auto  startedAt = Clock::now();
+        for (const auto* book : books) {
+            if ((book->formID & 0xFF00'0000) != TRACKED_PLUGIN || !book->teachesSpell) continue;
+            if (registry.FindByBookName(0, book->fullName.c_str())) found++;
+        }
+        return {found, Microseconds(Clock::now() - startedAt)};
+    }
+
+    // The scan it replaced: copy the form array, then compare each of the mod's books against every configured book name
+    std::pair<std::size_t, double> MatchLinear(const std::vector<const Book*>& books) {
+        std::map<SpellIndex, std::string> grantingBookNames;
+        for (std::size_t spell = 0; spell < FORGOTTEN_MAGIC_SPELL_COUNT; spell++) grantingBookNames.emplace(static_cast<SpellIndex>(spell), BookName(spell));
+
+        std::size_t found     = 0;
+        const auto  startedAt = Clock::now();
+        const auto  allBooks  = books;
+        for (const auto* book : allBooks) {
+            if ((book->formID & 0xFF00'0000) != TRACKED_PLUGIN || !book->teachesSpell) continue;
+            for (const auto& [spellIndex, grantingBookName] : grantingBookNames) {
+                if (std::strcmp(book->fullName.c_str(), grantingBookName.c_str()) == 0) {
+                    found++;
+                    break;
+                }
+            }
+        }
+        return {found, Microseconds(Clock::now() - startedAt)};
+    }
+
+    void ReportLoadOrder(const std::string& name, std::size_t trackedBookCount) {
+        // The game's form array holds pointers to the forms
+        const auto               books = BuildLoadOrder(trackedBookCount);
+        std::vector<const Book*> formArray;
+        for (const auto& book : books) formArray.push_back(&book);
+
+        const auto [hashedFound, hashed] = MatchHashed(formArray);
+        const auto [linearFound, linear] = MatchLinear(formArray);
+        Report(name + ": SpellRegistry book index", hashed, "us");
+        Report(name + ": linear scan", linear, "us");
+        Report(name + ": books matched, SpellRegistry", static_cast<double>(hashedFound), "books");
+        Report(name + ": books matched, linear", static_cast<double>(linearFound), "books");
+    }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(BookMatching) {
+    ReportLoadOrder("100k books, 1k from the mod", 1'000);
+    ReportLoadOrder("100k books, all from the mod", BOOK_COUNT);
+}
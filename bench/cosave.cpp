@@ -0,0 +1,89 @@
+// Work the co-save saves on the load path: restoring every spell's progress name from the
+// saved (progress, points), against the warm-up sweep it replaces, which captures each
+// slice of the player's spells from the XP source and renders their names
+//
+// Both are measured, with the player knowing every spell. The in-memory XP source is cheaper
+// to read than Papyrus arrays, so the sweep's figure is a lower bound. The sweep also waits
+// WARM_UP_SLICE_INTERVAL between slices; that wait is only derived from the constants, and
+// reported apart from the measurements.
+
+#include <ForgottenMagic/InMemory.h>
+#include <ForgottenMagic/RenderedNames.h>
+#include <ForgottenMagic/SpellNameUpdater.h>
+#include <ForgottenMagic/WarmUp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    constexpr std::size_t ROUNDS = 200;
+
+    void ShowOriginalNames(SyntheticCatalog& catalog) {
+        for (auto& renderer : catalog.nameRenderers) renderer.MarkOriginalName();
+    }
+
+    void MeasureLoad(std::size_t spellCount) {
+        SyntheticCatalog catalog(spellCount);
+        catalog.Advance(250);  // 50% and 2 points, so every spell shows a progress name
+        InMemoryNameSink names;
+
+        // What the save callback wrote
+        RenderedNames::Source saved{"ForgottenMagic", {}};
+        for (SpellHandle spell = 0; spell < spellCount; spell++) saved.entries.push_back({catalog.spellIndexes[spell], 2, 50, 0});
+        const auto bytes = RenderedNames::Encode(std::span(&saved, 1));
+
+        std::vector<double> restoreSamples, sliceSamples;
+        for (std::size_t round = 0; round < ROUNDS; round++) {
+            // Restore: decode the record and render every name from it
+            ShowOriginalNames(catalog);
+            auto startedAt = Clock::now();
+            if (auto sources = RenderedNames::Decode(bytes, RenderedNames::VERSION)) {
+                for (const auto& entry : (*sources)[0].entries) {
+                    const auto spell = static_cast<SpellHandle>(entry.spellIndex);
+                    if (auto* name = catalog.nameRenderers[spell].Render(catalog.originalNames[spell], entry.progress, entry.points)) names.SetName(spell, name);
+                }
+            }
+            restoreSamples.push_back(Microseconds(Clock::now() - startedAt));
+
+            // Warm-up sweep: one batch per slice of the player's spells, as the background thread runs them
+            ShowOriginalNames(catalog);
+            SpellNameUpdater         updater;
+            std::vector<SpellHandle> slice;
+            double                   sliceTotal = 0;
+            for (SpellHandle first = 0; first < spellCount; first += WARM_UP_SLICE_SIZE) {
+                slice.clear();
+                for (auto spell = first; spell < std::min<std::size_t>(first + WARM_UP_SLICE_SIZE, spellCount); spell++) slice.push_back(spell);
+                startedAt = Clock::now();
+                updater.Update(slice, catalog.Columns(), catalog.xpSource, names);
+                sliceTotal += Microseconds(Clock::now() - startedAt);
+            }
+            sliceSamples.push_back(sliceTotal);
+        }
+        Consume(names.renameCount);
+
+        const auto slices  = (spellCount + WARM_UP_SLICE_SIZE - 1) / WARM_UP_SLICE_SIZE;
+        const auto restore = Percentile(restoreSamples, 0.5);
+        const auto sweep   = Percentile(sliceSamples, 0.5);
+        const auto label   = std::to_string(spellCount) + " spells, ";
+        Report(label + "co-save restore (decode + render)", restore, "us");
+        Report(label + "sweep, " + std::to_string(slices) + " slices (capture + render)", sweep, "us");
+        Report(label + "sweep work the co-save replaces", sweep - restore, "us");
+        Report(label + "waits between slices (derived)", static_cast<double>(slices - 1) * Seconds(WARM_UP_SLICE_INTERVAL) * 1000, "ms");
+    }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(CoSaveRestore) {
+    MeasureLoad(FORGOTTEN_MAGIC_SPELL_COUNT);
+    MeasureLoad(10'000);
+}
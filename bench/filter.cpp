@@ -0,0 +1,106 @@
+// Cost per event of rejecting untracked magic effects: the SpellRegistry's EffectFilter
+// lookup against the path it replaced (global form lookup, plugin check, then a hash
+// lookup), on a synthetic stream of roughly 99% foreign effects and 1% tracked ones
+
+#include <ForgottenMagic/SpellRegistry.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    constexpr std::size_t   EVENT_COUNT       = 10'000'000;
+    constexpr std::size_t   GAME_FORM_COUNT   = 500'000;  // Stand-in for the game's global form table
+    constexpr std::uint32_t TRACKED_PLUGIN    = 0x2A00'0000;
+    constexpr std::size_t   EFFECTS_PER_SPELL = 2;
+    constexpr double        TRACKED_FRACTION  = 0.01;
+
+    // Stand-in for the game's spell forms, which the registry only points at
+    struct SpellForm {};
+
+    struct Stream {
+        std::vector<std::uint32_t>             trackedEffects;
+        std::vector<SpellForm>                 spellForms;
+        SpellRegistry<SpellForm>               registry;
+        std::unordered_map<std::uint32_t, int> gameForms;
+        std::unordered_map<std::uint32_t, int> spellsByEffect;
+        std::vector<std::uint32_t>             events;
+    };
+
+    void BuildStream(Stream& stream) {
+        std::mt19937 random(7);
+
+        // The progression mod's effects are spread over its own FormID range, among its other forms
+        std::vector<SpellDefinition> definitions;
+        for (std::size_t spell = 0; spell < FORGOTTEN_MAGIC_SPELL_COUNT; spell++) definitions.push_back({0, static_cast<SpellIndex>(spell), std::to_string(spell)});
+        stream.registry.Configure(std::move(definitions));
+        stream.spellForms.resize(FORGOTTEN_MAGIC_SPELL_COUNT);
+        for (std::size_t spell = 0; spell < FORGOTTEN_MAGIC_SPELL_COUNT; spell++) {
+            std::vector<std::uint32_t> effectFormIDs;
+            for (std::size_t effect = 0; effect < EFFECTS_PER_SPELL; effect++) {
+                const auto formID = TRACKED_PLUGIN + 0x800 + static_cast<std::uint32_t>(spell * 37 + effect * 5);
+                effectFormIDs.push_back(formID);
+                stream.trackedEffects.push_back(formID);
+                stream.spellsByEffect.emplace(formID, static_cast<int>(spell));
+            }
+            stream.registry.Bind(static_cast<SpellHandle>(spell), &stream.spellForms[spell], "Forgotten Spell " + std::to_string(spell), effectFormIDs);
+        }
+        stream.registry.FinishBinding();
+
+        // Every effect event names a form which exists, from any plugin in the load order
+        std::uniform_int_distribution<std::uint32_t> plugins(0, 0xFD), localIDs(0x800, 0xFFFFF);
+        std::vector<std::uint32_t>                   foreignEffects;
+        while (stream.gameForms.size() < GAME_FORM_COUNT) {
+            const auto formID = (plugins(random) << 24) | localIDs(random);
+            if (stream.spellsByEffect.contains(formID)) continue;
+            if (stream.gameForms.emplace(formID, 0).second && foreignEffects.size() < 20'000) foreignEffects.push_back(formID);
+        }
+        for (auto formID : stream.trackedEffects) stream.gameForms.emplace(formID, 1);
+
+        std::bernoulli_distribution                tracked(TRACKED_FRACTION);
+        std::uniform_int_distribution<std::size_t> foreignIndex(0, foreignEffects.size() - 1), trackedIndex(0, stream.trackedEffects.size() - 1);
+        stream.events.reserve(EVENT_COUNT);
+        for (std::size_t i = 0; i < EVENT_COUNT; i++)
+            stream.events.push_back(tracked(random) ? stream.trackedEffects[trackedIndex(random)] : foreignEffects[foreignIndex(random)]);
+    }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(EffectFilterStream) {
+    Stream stream;
+    BuildStream(stream);
+
+    // The plugin's path: one bitmap probe, which also ranks the 1% which pass into the registry's slots
+    std::uint64_t matched   = 0;
+    auto          startedAt = Clock::now();
+    for (const auto formID : stream.events)
+        if (stream.registry.FindByEffectFormID(formID)) matched++;
+    const auto filterElapsed = Clock::now() - startedAt;
+    Consume(matched);
+
+    // The path it replaced: look the form up in the global table, check its plugin, then look up the effect's spell
+    std::uint64_t baselineMatched = 0;
+    startedAt                     = Clock::now();
+    for (const auto formID : stream.events) {
+        const auto form = stream.gameForms.find(formID);
+        if (form == stream.gameForms.end() || (formID & 0xFF00'0000) != TRACKED_PLUGIN) continue;
+        const auto spell = stream.spellsByEffect.find(formID);
+        if (spell != stream.spellsByEffect.end()) baselineMatched++;
+    }
+    const auto baselineElapsed = Clock::now() - startedAt;
+    Consume(baselineMatched);
+
+    Report("SpellRegistry effect lookup, per event", Nanoseconds(filterElapsed) / EVENT_COUNT, "ns");
+    Report("form lookup + plugin check + hash lookup, per event", Nanoseconds(baselineElapsed) / EVENT_COUNT, "ns");
+    Report("tracked events, found by both paths", static_cast<double>(std::min(matched, baselineMatched)), "events");
+    Report("tracked events, found by one path only", static_cast<double>(std::max(matched, baselineMatched) - std::min(matched, baselineMatched)), "events");
+}
@@ -0,0 +1,150 @@
+// Producer-side cost of recording a cast under contention: the lock-free SpellUseInbox
+// against the mutex-guarded map QueueSpell used to write, with several event threads
+// spamming casts while the background thread consumes them
+
+#include <ForgottenMagic/DebounceScheduler.h>
+#include <ForgottenMagic/SpellUseInbox.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    constexpr std::size_t PRODUCER_COUNT      = 4;
+    constexpr std::size_t EVENTS_PER_PRODUCER = 250'000;
+    constexpr auto        QUIET_PERIOD        = std::chrono::milliseconds(1000);
+
+    struct StressResult {
+        double              eventsPerSecond{0.0};
+        std::vector<double> recordNs;  // Every producer call
+    };
+
+    /**
+     * Runs PRODUCER_COUNT threads which each call record(spell) EVENTS_PER_PRODUCER times
+     *
+     * @param consume Runs on its own thread until stop is set
+     */
+    template <typename Record, typename Consume>
+    StressResult Stress(Record&& record, Consume&& consume, std::atomic<bool>& stop) {
+        std::thread consumer([&] { consume(); });
+
+        std::atomic<bool>                go{false};
+        std::vector<std::vector<double>> latencies(PRODUCER_COUNT);
+        std::vector<std::thread>         producers;
+        for (std::size_t p = 0; p < PRODUCER_COUNT; p++) {
+            latencies[p].reserve(EVENTS_PER_PRODUCER);
+            producers.emplace_back([&, p] {
+                while (!go.load()) std::this_thread::yield();
+                for (std::size_t i = 0; i < EVENTS_PER_PRODUCER; i++) {
+                    const auto spell     = static_cast<SpellHandle>((i * 7 + p) % FORGOTTEN_MAGIC_SPELL_COUNT);
+                    const auto startedAt = Clock::now();
+                    record(spell);
+                    latencies[p].push_back(Nanoseconds(Clock::now() - startedAt));
+                }
+            });
+        }
+
+        const auto startedAt = Clock::now();
+        go                   = true;
+        for (auto& producer : producers) producer.join();
+        const auto elapsed = Clock::now() - startedAt;
+        stop               = true;
+        consumer.join();
+
+        StressResult result;
+        result.eventsPerSecond = static_cast<double>(PRODUCER_COUNT * EVENTS_PER_PRODUCER) / Seconds(elapsed);
+        for (auto& samples : latencies) result.recordNs.insert(result.recordNs.end(), samples.begin(), samples.end());
+        return result;
+    }
+
+    // The plugin's path: lock-free push, and the consumer's mutex only when it must be woken
+    StressResult StressInbox() {
+        SpellUseInbox           inbox;
+        DebounceScheduler       scheduler(QUIET_PERIOD);
+        std::mutex              mutex;
+        std::condition_variable cv;
+        std::atomic<bool>       stop{false};
+        inbox.Resize(FORGOTTEN_MAGIC_SPELL_COUNT);
+        scheduler.Resize(FORGOTTEN_MAGIC_SPELL_COUNT);
+
+        return Stress(
+            [&](SpellHandle spell) {
+                const auto now = Clock::now();
+                if (inbox.Record(spell, now, now + scheduler.MinimumDelay(spell))) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    cv.notify_one();
+                }
+            },
+            [&] {
+                std::vector<SpellHandle> due;
+                while (!stop) {
+                    {
+                        // The sleep is capped so the consumer notices stop without being notified
+                        std::unique_lock<std::mutex> lock(mutex);
+                        const auto                   nextDeadline = scheduler.Empty() ? Clock::time_point::max() : scheduler.NextDeadline();
+                        const auto                   sleepUntil   = std::min(nextDeadline, Clock::now() + std::chrono::milliseconds(10));
+                        if (inbox.BeginSleep(sleepUntil)) cv.wait_until(lock, sleepUntil, [&] { return !inbox.IsSleeping(); });
+                        inbox.EndSleep();
+                    }
+                    inbox.Drain([&](SpellHandle spell, Clock::time_point usedAt) { scheduler.Schedule(spell, usedAt); });
+                    scheduler.PopDue(Clock::now(), due);
+                }
+            },
+            stop);
+    }
+
+    // The path it replaced: every cast locks queue_mutex, writes the map and notifies; the consumer scans the map under the same lock
+    StressResult StressMutex() {
+        std::mutex                                         mutex;
+        std::condition_variable                            cv;
+        std::unordered_map<SpellHandle, Clock::time_point> lastUseTimes;
+        std::atomic<bool>                                  stop{false};
+
+        return Stress(
+            [&](SpellHandle spell) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    lastUseTimes[spell] = Clock::now();
+                }
+                cv.notify_one();
+            },
+            [&] {
+                while (!stop) {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait_for(lock, std::chrono::milliseconds(100));
+                    const auto now = Clock::now();
+                    for (auto entry = lastUseTimes.begin(); entry != lastUseTimes.end();) {
+                        if (now - entry->second >= QUIET_PERIOD) entry = lastUseTimes.erase(entry);
+                        else ++entry;
+                    }
+                }
+            },
+            stop);
+    }
+
+    void ReportStress(const char* name, StressResult result) {
+        Report(std::string(name) + ": events/sec", result.eventsPerSecond, "events/s");
+        Report(std::string(name) + ": producer call, p50", Percentile(result.recordNs, 0.5), "ns");
+        Report(std::string(name) + ": producer call, p99", Percentile(result.recordNs, 0.99), "ns");
+        Report(std::string(name) + ": producer call, p99.9", Percentile(result.recordNs, 0.999), "ns");
+    }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(IngestionContention) {
+    ReportStress("MPSC inbox", StressInbox());
+    ReportStress("mutex + map", StressMutex());
+}
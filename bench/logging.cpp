@@ -0,0 +1,113 @@
+// Game-thread cost of the per-event trace message ("Found a Forgotten Magic spell was used")
+// through AsyncLog, when enabled and when gated off at runtime, against the synchronous
+// path it replaced, which formatted the line and wrote it to the log file on the calling
+// thread (both format with AsyncLog's FormatLibrary: std::format, or fmt with --fmt=y)
+
+#include <ForgottenMagic/AsyncLog.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    // Bursts of events no larger than the ring, with the writer catching up in between, so nothing is dropped
+    constexpr std::size_t BURST_SIZE  = 512;
+    constexpr std::size_t BURST_COUNT = 400;
+
+    // Stand-in for the log file sink: appends the line and flushes, as the SKSE log does per message
+    struct FileSink {
+        std::FILE*                 file = std::tmpfile();
+        std::atomic<std::uint64_t> lines{0};
+
+        ~FileSink() {
+            if (file) std::fclose(file);
+        }
+
+        void Write(std::string_view line) {
+            std::fwrite(line.data(), 1, line.size(), file);
+            std::fputc('\n', file);
+            std::fflush(file);
+            lines.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    // Times each call of one burst after another; the clock reads are included in every sample, see the empty call
+    template <typename Call, typename BetweenBursts>
+    std::vector<double> TimeCalls(const SyntheticCatalog& catalog, Call&& call, BetweenBursts&& betweenBursts) {
+        std::vector<double> samples;
+        samples.reserve(BURST_SIZE * BURST_COUNT);
+        for (std::size_t burst = 0; burst < BURST_COUNT; burst++) {
+            for (std::size_t i = 0; i < BURST_SIZE; i++) {
+                const auto& name      = catalog.originalNames[(burst * BURST_SIZE + i) % catalog.Size()];
+                const auto  startedAt = Clock::now();
+                call(name);
+                samples.push_back(Nanoseconds(Clock::now() - startedAt));
+            }
+            betweenBursts(burst + 1);
+        }
+        return samples;
+    }
+
+    void ReportSamples(std::string_view path, std::vector<double>& samples) {
+        double total = 0;
+        for (auto sample : samples) total += sample;
+        Report(std::string(path) + ", mean per event", total / static_cast<double>(samples.size()), "ns");
+        Report(std::string(path) + ", p50", Percentile(samples, 0.50), "ns");
+        Report(std::string(path) + ", p99", Percentile(samples, 0.99), "ns");
+        Report(std::string(path) + ", p99.9", Percentile(samples, 0.999), "ns");
+    }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(EventPathLogging) {
+    const SyntheticCatalog catalog(FORGOTTEN_MAGIC_SPELL_COUNT);
+    const auto             nothing = [](std::size_t) {};
+
+    // The path it replaced: format, then write and flush on the calling thread
+    FileSink    syncFile;
+    std::string line;
+    auto        syncSamples = TimeCalls(
+        catalog,
+        [&](const std::string& name) {
+            line.clear();
+            FormatLibrary::format_to(std::back_inserter(line), "Found a Forgotten Magic spell was used: {}", name);
+            syncFile.Write(line);
+        },
+        nothing);
+
+    // AsyncLog with trace enabled: the caller only copies the name into the ring
+    FileSink asyncFile;
+    AsyncLog log;
+    log.SetLevel(LogLevel::Trace);
+    log.Start([&](LogLevel, std::string_view written) { asyncFile.Write(written); });
+    auto asyncSamples = TimeCalls(
+        catalog, [&](const std::string& name) { log.Write<LogLevel::Trace>("Found a Forgotten Magic spell was used: {}", name); },
+        [&](std::size_t bursts) {
+            while (asyncFile.lines.load(std::memory_order_relaxed) < bursts * BURST_SIZE) std::this_thread::sleep_for(std::chrono::microseconds(100));
+        });
+
+    // Trace gated off at runtime, as in a release install at the default info level
+    log.SetLevel(LogLevel::Info);
+    auto gatedSamples = TimeCalls(catalog, [&](const std::string& name) { log.Write<LogLevel::Trace>("Found a Forgotten Magic spell was used: {}", name); }, nothing);
+    log.Stop();
+
+    auto emptySamples = TimeCalls(catalog, [](const std::string& name) { Consume(name.size()); }, nothing);
+
+    ReportSamples("synchronous format + write", syncSamples);
+    ReportSamples("AsyncLog, trace enabled", asyncSamples);
+    ReportSamples("AsyncLog, trace gated off at runtime", gatedSamples);
+    ReportSamples("empty call (clock overhead)", emptySamples);
+    Report("lines written by AsyncLog (of those logged)", static_cast<double>(asyncFile.lines.load()), "lines");
+}
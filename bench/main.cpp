@@ -0,0 +1,66 @@
+// Host benchmarks of the core pipeline, runnable without the game
+//
+// Usage: ForgottenMagicBench [--list] [filter...]
+//
+// Runs every benchmark whose name contains one of the filters (all of them without filters).
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <vector>
+
+#include "Bench.h"
+
+namespace {
+    // Each allocation is preceded by its size, padded to keep operator new's alignment
+    constexpr std::size_t SIZE_HEADER = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    std::atomic<std::size_t> allocatedBytes{0};
+}
+
+std::size_t ForgottenMagic::Bench::AllocatedBytes() { return allocatedBytes.load(std::memory_order_relaxed); }
+
+// Counts the bytes held by every container, so footprints can be measured on the real types
+void* operator new(std::size_t size) {
+    auto* block = static_cast<std::byte*>(std::malloc(size + SIZE_HEADER));
+    if (!block) throw std::bad_alloc();
+    std::memcpy(block, &size, sizeof(size));
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return block + SIZE_HEADER;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) return;
+    auto*       block = static_cast<std::byte*>(pointer) - SIZE_HEADER;
+    std::size_t size;
+    std::memcpy(&size, block, sizeof(size));
+    allocatedBytes.fetch_sub(size, std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept { operator delete(pointer); }
+
+int main(int argc, char** argv) {
+    auto                          list = false;
+    std::vector<std::string_view> filters;
+    for (int i = 1; i < argc; i++) {
+        std::string_view argument = argv[i];
+        if (argument == "--list") list = true;
+        else filters.push_back(argument);
+    }
+
+    for (const auto& benchmark : ForgottenMagic::Bench::Registry()) {
+        const std::string_view name = benchmark.name;
+        if (!filters.empty() && std::ranges::none_of(filters, [name](std::string_view filter) { return name.find(filter) != std::string_view::npos; })) continue;
+        std::printf("%s\n", benchmark.name);
+        if (list) continue;
+        benchmark.run();
+        std::fflush(stdout);
+    }
+    return 0;
+}
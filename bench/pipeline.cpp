@@ -0,0 +1,130 @@
+// Throughput and latency of the pipeline stages the plugin runs for every cast:
+// ingestion into the inbox and scheduler, batch processing, and applying renames
+
+#include <ForgottenMagic/DebounceScheduler.h>
+#include <ForgottenMagic/InMemory.h>
+#include <ForgottenMagic/NameApplyQueue.h>
+#include <ForgottenMagic/SpellNameUpdater.h>
+#include <ForgottenMagic/SpellUseInbox.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    // Events/sec from producer threads through SpellUseInbox::Record, drained into the scheduler as the background thread does
+    double MeasureIngestion(std::size_t producerCount, std::size_t eventsPerProducer) {
+        constexpr std::size_t SPELL_COUNT = FORGOTTEN_MAGIC_SPELL_COUNT;
+
+        SpellUseInbox     inbox;
+        DebounceScheduler scheduler(std::chrono::milliseconds(1000));
+        inbox.Resize(SPELL_COUNT);
+        scheduler.Resize(SPELL_COUNT);
+
+        std::atomic<std::size_t> producersRunning{producerCount};
+        std::atomic<bool>        go{false};
+        std::uint64_t            drained = 0;
+        std::thread              consumer([&] {
+            std::vector<SpellHandle> due;
+            while (producersRunning.load() > 0 || !inbox.BeginSleep(Clock::time_point::max())) {
+                inbox.EndSleep();
+                inbox.Drain([&](SpellHandle spell, Clock::time_point usedAt) {
+                    scheduler.Schedule(spell, usedAt);
+                    drained++;
+                });
+                scheduler.PopDue(Clock::now(), due);
+                std::this_thread::yield();
+            }
+            inbox.EndSleep();
+        });
+
+        std::vector<std::thread> producers;
+        for (std::size_t p = 0; p < producerCount; p++) {
+            producers.emplace_back([&, p] {
+                while (!go.load()) std::this_thread::yield();
+                for (std::size_t i = 0; i < eventsPerProducer; i++) {
+                    const auto spell = static_cast<SpellHandle>((i * 7 + p) % SPELL_COUNT);
+                    const auto now   = Clock::now();
+                    inbox.Record(spell, now, now + scheduler.MinimumDelay(spell));
+                }
+                producersRunning--;
+            });
+        }
+
+        const auto startedAt = Clock::now();
+        go                   = true;
+        for (auto& producer : producers) producer.join();
+        const auto producedIn = Clock::now() - startedAt;
+        consumer.join();
+
+        Consume(drained);
+        return static_cast<double>(producerCount * eventsPerProducer) / Seconds(producedIn);
+    }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(Ingestion) {
+    Report("events/sec, 1 producer", MeasureIngestion(1, 2'000'000), "events/s");
+    Report("events/sec, 4 producers", MeasureIngestion(4, 500'000), "events/s");
+}
+
+// Latency of one SpellNameUpdater batch over every configured spell: snapshot, progress, render, rename
+FORGOTTEN_MAGIC_BENCHMARK(BatchLatency) {
+    constexpr std::size_t ITERATIONS = 20'000;
+
+    SyntheticCatalog         catalog(FORGOTTEN_MAGIC_SPELL_COUNT);
+    InMemoryNameSink         names;
+    SpellNameUpdater         updater;
+    std::vector<SpellHandle> batch(catalog.Size());
+    for (std::size_t i = 0; i < batch.size(); i++) batch[i] = static_cast<SpellHandle>(i);
+
+    std::vector<double> changed, unchanged;
+    for (std::size_t i = 0; i < ITERATIONS; i++) {
+        catalog.Advance(static_cast<std::uint32_t>(i));
+        auto startedAt = Clock::now();
+        updater.Update(batch, catalog.Columns(), catalog.xpSource, names);
+        changed.push_back(Microseconds(Clock::now() - startedAt));
+
+        startedAt = Clock::now();
+        updater.Update(batch, catalog.Columns(), catalog.xpSource, names);
+        unchanged.push_back(Microseconds(Clock::now() - startedAt));
+    }
+    Consume(names.renameCount);
+    Report("41-spell batch, every name changes, p50", Percentile(changed, 0.5), "us");
+    Report("41-spell batch, every name changes, p99", Percentile(changed, 0.99), "us");
+    Report("41-spell batch, no name changes, p50", Percentile(unchanged, 0.5), "us");
+    Report("41-spell batch, no name changes, p99", Percentile(unchanged, 0.99), "us");
+}
+
+// Renames/sec through NameApplyQueue: posted by the pipeline, applied one frame at a time
+FORGOTTEN_MAGIC_BENCHMARK(RenameThroughput) {
+    constexpr std::size_t FRAMES = 50'000;
+
+    SyntheticCatalog catalog(FORGOTTEN_MAGIC_SPELL_COUNT);
+    InMemoryNameSink names;
+    NameApplyQueue   queue;
+    queue.Configure(catalog.Size(), names, std::chrono::seconds(1));
+
+    std::vector<std::string> rendered(catalog.Size());
+    for (std::size_t i = 0; i < catalog.Size(); i++) rendered[i] = catalog.originalNames[i] + " (50%)**";
+
+    const auto startedAt = Clock::now();
+    for (std::size_t frame = 0; frame < FRAMES; frame++) {
+        for (SpellHandle spell = 0; spell < catalog.Size(); spell++) queue.SetName(spell, rendered[spell].c_str());
+        queue.ApplyPending();
+    }
+    const auto elapsed = Clock::now() - startedAt;
+
+    Consume(names.renameCount);
+    Report("renames/sec, posted and applied", static_cast<double>(names.renameCount) / Seconds(elapsed), "renames/s");
+    Report("per rename", Nanoseconds(elapsed) / static_cast<double>(names.renameCount), "ns");
+}
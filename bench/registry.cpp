@@ -0,0 +1,148 @@
+// Memory footprint and lookup cost of the plugin's SpellRegistry against the three hash maps
+// it replaced, for the 41 configured spells with two effects each, and at 10k spells
+//
+// Footprint counts the bytes each layout allocates, through the harness's counting operator
+// new. The old maps are modelled with std::unordered_map; the registry is the real one, with
+// its name renderers (which are new) included.
+
+#include <ForgottenMagic/Interfaces.h>
+#include <ForgottenMagic/SpellRegistry.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    constexpr std::size_t EFFECTS_PER_SPELL = 2;
+    constexpr std::size_t LOOKUPS           = 10'000'000;
+
+    // Stand-ins for the game's forms: only their addresses and FormIDs matter
+    struct SpellForm {
+        std::uint32_t formID;
+    };
+
+    std::uint32_t EffectFormID(std::size_t spell, std::size_t effect) { return 0x2A00'0800 + static_cast<std::uint32_t>(spell * 37 + effect * 5); }
+    std::string   SpellName(std::size_t spell) { return "Forgotten Spell " + std::to_string(spell); }
+    std::string   BookName(std::size_t spell) { return "Spell Tome: Forgotten Spell " + std::to_string(spell); }
+
+    // The layout it replaced: every spell's info by index, effect -> spell, and a full copy of the info by spell
+    struct SpellInfo {
+        SpellForm*  spell{nullptr};
+        SpellIndex  spellIndex{0};
+        std::string originalSpellName;
+        std::string grantingBookName;
+    };
+    struct MapLayout {
+        std::unordered_map<SpellIndex, SpellInfo>     spellInfosByIndex;
+        std::unordered_map<std::uint32_t, SpellForm*> spellEffectsBySpellEffectFormID;
+        std::unordered_map<SpellForm*, SpellInfo>     spellInfosBySpellItem;
+
+        explicit MapLayout(std::vector<SpellForm>& forms) {
+            for (std::size_t spell = 0; spell < forms.size(); spell++) {
+                auto& info             = spellInfosByIndex[static_cast<SpellIndex>(spell)];
+                info.spell             = &forms[spell];
+                info.spellIndex        = static_cast<SpellIndex>(spell);
+                info.originalSpellName = SpellName(spell);
+                info.grantingBookName  = BookName(spell);
+                for (std::size_t effect = 0; effect < EFFECTS_PER_SPELL; effect++) {
+                    spellEffectsBySpellEffectFormID.emplace(EffectFormID(spell, effect), &forms[spell]);
+                    spellInfosBySpellItem.emplace(&forms[spell], info);
+                }
+            }
+        }
+
+        // Effect -> spell -> info, as ProcessEvent and UpdateSpellsXP used to
+        const SpellInfo* FindByEffectFormID(std::uint32_t effectFormID) const {
+            auto spell = spellEffectsBySpellEffectFormID.find(effectFormID);
+            if (spell == spellEffectsBySpellEffectFormID.end()) return nullptr;
+            auto info = spellInfosBySpellItem.find(spell->second);
+            return info == spellInfosBySpellItem.end() ? nullptr : &info->second;
+        }
+    };
+
+    // The registry as the plugin fills it: one source, every spell bound with its effects
+    struct BoundRegistry {
+        SpellRegistry<SpellForm> registry;
+
+        explicit BoundRegistry(std::vector<SpellForm>& forms) {
+            std::vector<SpellDefinition> definitions;
+            for (std::size_t spell = 0; spell < forms.size(); spell++) definitions.push_back({0, static_cast<SpellIndex>(spell), BookName(spell)});
+            registry.Configure(std::move(definitions));
+
+            std::vector<std::uint32_t> effectFormIDs;
+            for (std::size_t spell = 0; spell < forms.size(); spell++) {
+                effectFormIDs.clear();
+                for (std::size_t effect = 0; effect < EFFECTS_PER_SPELL; effect++) effectFormIDs.push_back(EffectFormID(spell, effect));
+                registry.Bind(static_cast<SpellHandle>(spell), &forms[spell], SpellName(spell), effectFormIDs);
+            }
+            registry.FinishBinding();
+        }
+    };
+
+    // Bytes a layout holds once built
+    template <typename Layout>
+    double FootprintOf(std::vector<SpellForm>& forms) {
+        const auto   before = AllocatedBytes();
+        const Layout layout(forms);
+        return static_cast<double>(AllocatedBytes() - before);
+    }
+
+    void MeasureLayouts(std::size_t spellCount) {
+        std::vector<SpellForm> forms(spellCount);
+        for (std::size_t spell = 0; spell < forms.size(); spell++) forms[spell].formID = 0x2A00'1000 + static_cast<std::uint32_t>(spell);
+
+        const auto label = std::to_string(spellCount) + " spells, ";
+        Report(label + "footprint, three hash maps", FootprintOf<MapLayout>(forms), "bytes");
+        Report(label + "footprint, SpellRegistry", FootprintOf<BoundRegistry>(forms), "bytes");
+
+        const MapLayout     maps(forms);
+        const BoundRegistry dense(forms);
+        const auto&         registry = dense.registry;
+
+        std::mt19937                               random(11);
+        std::uniform_int_distribution<std::size_t> spells(0, forms.size() - 1), effects(0, EFFECTS_PER_SPELL - 1);
+        std::vector<std::uint32_t>                 effectLookups(4096);
+        for (auto& effectFormID : effectLookups) effectFormID = EffectFormID(spells(random), effects(random));
+
+        // Effect FormID -> spell's original name, as the event path needs it
+        std::uint64_t found     = 0;
+        auto          startedAt = Clock::now();
+        for (std::size_t i = 0; i < LOOKUPS; i++)
+            if (auto* info = maps.FindByEffectFormID(effectLookups[i & 4095])) found += info->originalSpellName.size();
+        const auto mapsElapsed = Clock::now() - startedAt;
+
+        startedAt = Clock::now();
+        for (std::size_t i = 0; i < LOOKUPS; i++)
+            if (auto slot = registry.FindByEffectFormID(effectLookups[i & 4095])) found += registry.originalNames[*slot].size();
+        const auto denseElapsed = Clock::now() - startedAt;
+
+        // Spell index -> spell, as a batch needs it
+        startedAt = Clock::now();
+        for (std::size_t i = 0; i < LOOKUPS; i++) found += maps.spellInfosByIndex.find(static_cast<SpellIndex>(i % forms.size()))->second.spell->formID;
+        const auto mapsByIndexElapsed = Clock::now() - startedAt;
+
+        startedAt = Clock::now();
+        for (std::size_t i = 0; i < LOOKUPS; i++) found += registry.spells[i % forms.size()]->formID;
+        const auto denseByIndexElapsed = Clock::now() - startedAt;
+
+        Consume(found);
+        Report(label + "effect -> spell, three hash maps", Nanoseconds(mapsElapsed) / LOOKUPS, "ns");
+        Report(label + "effect -> spell, SpellRegistry", Nanoseconds(denseElapsed) / LOOKUPS, "ns");
+        Report(label + "spell index -> spell, hash map", Nanoseconds(mapsByIndexElapsed) / LOOKUPS, "ns");
+        Report(label + "spell index -> spell, SpellRegistry", Nanoseconds(denseByIndexElapsed) / LOOKUPS, "ns");
+    }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(RegistryLayout) {
+    MeasureLayouts(FORGOTTEN_MAGIC_SPELL_COUNT);
+    MeasureLayouts(10'000);
+}
@@ -0,0 +1,81 @@
+// Updates/sec of rendering all 41 spell names: SpellNameRenderer (reserved buffer, skips
+// unchanged state) against the std::format path it replaced, which always renamed
+// (formatted with FormatLibrary: std::format, or fmt with --fmt=y)
+
+#include <ForgottenMagic/Format.h>
+#include <ForgottenMagic/InMemory.h>
+#include <ForgottenMagic/SpellNameRenderer.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    constexpr std::size_t ROUNDS = 200'000;
+
+    // Progress and points of a spell in a round; changes every round unless held
+    std::int32_t  ProgressAt(std::size_t round, std::size_t spell) { return static_cast<std::int32_t>((round + spell) % 100); }
+    std::uint32_t PointsAt(std::size_t round, std::size_t spell) { return static_cast<std::uint32_t>((round / 100 + spell) % 4); }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(NameRendering) {
+    SyntheticCatalog catalog(FORGOTTEN_MAGIC_SPELL_COUNT);
+    InMemoryNameSink names;
+    const auto       updates = static_cast<double>(ROUNDS * catalog.Size());
+
+    // Every round changes every spell's progress, so every update renders and renames
+    std::uint64_t issued = 0, skipped = 0;
+    auto          startedAt = Clock::now();
+    for (std::size_t round = 0; round < ROUNDS; round++) {
+        for (SpellHandle spell = 0; spell < catalog.Size(); spell++) {
+            if (auto* name = catalog.nameRenderers[spell].Render(catalog.originalNames[spell], ProgressAt(round, spell), PointsAt(round, spell))) {
+                names.SetName(spell, name);
+                issued++;
+            } else {
+                skipped++;
+            }
+        }
+    }
+    const auto changedElapsed = Clock::now() - startedAt;
+
+    // The same state again every round: nothing is rendered or renamed
+    startedAt = Clock::now();
+    for (std::size_t round = 0; round < ROUNDS; round++) {
+        for (SpellHandle spell = 0; spell < catalog.Size(); spell++) {
+            if (auto* name = catalog.nameRenderers[spell].Render(catalog.originalNames[spell], ProgressAt(0, spell), PointsAt(0, spell))) {
+                names.SetName(spell, name);
+                issued++;
+            } else {
+                skipped++;
+            }
+        }
+    }
+    const auto unchangedElapsed = Clock::now() - startedAt;
+
+    // The path it replaced: copy the name, build the points string, format, and always rename
+    startedAt = Clock::now();
+    for (std::size_t round = 0; round < ROUNDS; round++) {
+        for (SpellHandle spell = 0; spell < catalog.Size(); spell++) {
+            auto originalName             = catalog.originalNames[spell];
+            auto progress                 = ProgressAt(round, spell);
+            auto availablePointsIndicator = std::string(PointsAt(round, spell), '*');
+            if (progress == 0) names.SetName(spell, FormatLibrary::format("{}{}", originalName, availablePointsIndicator).c_str());
+            else names.SetName(spell, FormatLibrary::format("{} ({}%){}", originalName, progress, availablePointsIndicator).c_str());
+        }
+    }
+    const auto formatElapsed = Clock::now() - startedAt;
+
+    Consume(names.renameCount);
+    Report("renderer, every state changed", updates / Seconds(changedElapsed), "updates/s");
+    Report("renderer, no state changed", updates / Seconds(unchangedElapsed), "updates/s");
+    Report("std::format, always renamed", updates / Seconds(formatElapsed), "updates/s");
+    Report("renderer renames issued", static_cast<double>(issued), "renames");
+    Report("renderer renames skipped", static_cast<double>(skipped), "renames");
+}
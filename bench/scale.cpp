@@ -0,0 +1,144 @@
+// The pipeline at a 10k-spell catalog from three progression sources: batches of a few
+// spells, which only copy their own entries from the XP source, against copying every
+// entry as batches used to; and the event path, the registry's effect lookup plus inbox
+
+#include <ForgottenMagic/InMemory.h>
+#include <ForgottenMagic/SpellNameUpdater.h>
+#include <ForgottenMagic/SpellRegistry.h>
+#include <ForgottenMagic/SpellUseInbox.h>
+#include <ForgottenMagic/XpSnapshot.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Bench.h"
+#include "Catalog.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    constexpr std::size_t SPELL_COUNT       = 10'000;
+    constexpr std::size_t SOURCE_COUNT      = 3;
+    constexpr std::size_t EFFECTS_PER_SPELL = 2;
+    constexpr std::size_t BATCH_ROUNDS      = 2'000;
+    constexpr std::size_t EVENT_COUNT       = 10'000'000;
+    constexpr double      TRACKED_FRACTION  = 0.01;
+
+    // The batch path before batches captured only their own entries: every entry copied and computed
+    void UpdateWithFullCapture(std::span<const SpellHandle> spells, SyntheticCatalog& catalog, XpSnapshot& snapshot, INameSink& sink) {
+        if (!catalog.xpSource.Capture(snapshot)) return;
+        snapshot.ComputeProgress();
+        for (const auto spell : spells) {
+            const auto spellIndex = catalog.spellIndexes[spell];
+            if (snapshot.Invalid(spellIndex)) continue;
+            auto* name = catalog.nameRenderers[spell].Render(catalog.originalNames[spell], snapshot.Progress(spellIndex), snapshot.Points(spellIndex));
+            if (name) sink.SetName(spell, name);
+        }
+    }
+
+    // p50/p99 of batches of batchSize random spells, which all change name every round
+    template <typename Update>
+    void MeasureBatches(SyntheticCatalog& catalog, std::size_t batchSize, std::string_view path, Update&& update) {
+        std::mt19937                               random(11);
+        std::uniform_int_distribution<SpellHandle> spells(0, static_cast<SpellHandle>(catalog.Size() - 1));
+        std::vector<SpellHandle>                   batch(batchSize);
+        std::vector<double>                        samples;
+        samples.reserve(BATCH_ROUNDS);
+        for (std::size_t round = 0; round < BATCH_ROUNDS; round++) {
+            catalog.Advance(static_cast<std::uint32_t>(round + 1));
+            for (auto& spell : batch) spell = spells(random);
+            std::ranges::sort(batch);
+
+            const auto startedAt = Clock::now();
+            update(std::span<const SpellHandle>(batch));
+            samples.push_back(Microseconds(Clock::now() - startedAt));
+        }
+        const auto label = std::to_string(batchSize) + "-spell batch, " + std::string(path);
+        Report(label + ", p50", Percentile(samples, 0.5), "us");
+        Report(label + ", p99", Percentile(samples, 0.99), "us");
+    }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(LargeCatalogBatches) {
+    SyntheticCatalog catalog(SPELL_COUNT);
+    InMemoryNameSink names;
+    SpellNameUpdater updater;
+    XpSnapshot       fullSnapshot;
+
+    for (const std::size_t batchSize : {1, 8}) {
+        MeasureBatches(catalog, batchSize, "batch entries only", [&](std::span<const SpellHandle> batch) { updater.Update(batch, catalog.Columns(), catalog.xpSource, names); });
+        MeasureBatches(catalog, batchSize, "every entry", [&](std::span<const SpellHandle> batch) { UpdateWithFullCapture(batch, catalog, fullSnapshot, names); });
+    }
+    Consume(names.renameCount);
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(LargeCatalogEvents) {
+    // Each source's effects sit in its own plugin's FormID range, with the rest of the load order around them
+    struct SpellForm {};
+    std::vector<SpellDefinition> definitions;
+    for (SpellHandle spell = 0; spell < SPELL_COUNT; spell++)
+        definitions.push_back({static_cast<SourceId>(spell % SOURCE_COUNT), static_cast<SpellIndex>(spell / SOURCE_COUNT), std::to_string(spell)});
+    SpellRegistry<SpellForm> registry;
+    registry.Configure(std::move(definitions));
+
+    std::vector<SpellForm>     spellForms(SPELL_COUNT);
+    std::vector<std::uint32_t> trackedEffects, effectFormIDs;
+    for (SpellHandle slot = 0; slot < SPELL_COUNT; slot++) {
+        const auto source = registry.sourceIds[slot];
+        const auto plugin = static_cast<std::uint32_t>(0x20 + source * 0x31) << 24;
+        effectFormIDs.clear();
+        for (std::size_t effect = 0; effect < EFFECTS_PER_SPELL; effect++)
+            effectFormIDs.push_back(plugin | static_cast<std::uint32_t>(0x800 + registry.spellIndexes[slot] * 11 + effect * 3));
+        registry.Bind(slot, &spellForms[slot], "Forgotten Spell " + std::to_string(slot), effectFormIDs);
+        trackedEffects.insert(trackedEffects.end(), effectFormIDs.begin(), effectFormIDs.end());
+    }
+    registry.FinishBinding();
+    std::ranges::sort(trackedEffects);
+
+    SpellUseInbox inbox;
+    inbox.Resize(SPELL_COUNT);
+
+    std::mt19937                                 random(5);
+    std::bernoulli_distribution                  tracked(TRACKED_FRACTION);
+    std::uniform_int_distribution<std::size_t>   trackedIndex(0, trackedEffects.size() - 1);
+    std::uniform_int_distribution<std::uint32_t> plugins(0, 0xFD), localIDs(0x800, 0xFFFFF);
+    std::vector<std::uint32_t>                   events;
+    events.reserve(EVENT_COUNT);
+    while (events.size() < EVENT_COUNT) {
+        if (tracked(random)) {
+            events.push_back(trackedEffects[trackedIndex(random)]);
+            continue;
+        }
+        const auto formID = (plugins(random) << 24) | localIDs(random);
+        if (!std::ranges::binary_search(trackedEffects, formID)) events.push_back(formID);
+    }
+
+    // As ProcessEvent: the registry's effect lookup, then hand the cast to the inbox; drained between chunks, untimed
+    constexpr std::size_t CHUNK   = 100'000;
+    std::uint64_t         matched = 0;
+    Clock::duration       elapsed{};
+    for (std::size_t first = 0; first < events.size(); first += CHUNK) {
+        const auto startedAt = Clock::now();
+        for (std::size_t i = first; i < first + CHUNK; i++) {
+            const auto slot = registry.FindByEffectFormID(events[i]);
+            if (!slot) continue;
+            const auto now = Clock::now();
+            inbox.Record(*slot, now, now + std::chrono::milliseconds(150));
+            matched++;
+        }
+        elapsed += Clock::now() - startedAt;
+        inbox.Drain([](SpellHandle, Clock::time_point) {});
+    }
+    Consume(matched);
+
+    Report("10k spells / 20k effects in 3 plugins, per event", Nanoseconds(elapsed) / EVENT_COUNT, "ns");
+    Report("tracked events handed to the inbox", static_cast<double>(matched), "events");
+}
@@ -0,0 +1,165 @@
+// Idle wakeups and pickup jitter of the background thread's sleep loop with thousands of
+// tracked spells: the deadline heap (DebounceScheduler + SpellUseInbox) against the 100ms
+// polling scan of a mutex-guarded map it replaced
+
+#include <ForgottenMagic/DebounceScheduler.h>
+#include <ForgottenMagic/SpellUseInbox.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Bench.h"
+
+using namespace ForgottenMagic;
+using namespace ForgottenMagic::Bench;
+
+namespace {
+    constexpr std::size_t SPELL_COUNT   = 5000;
+    constexpr std::size_t CAST_COUNT    = 20'000;
+    constexpr auto        CAST_SPAN     = std::chrono::milliseconds(1000);
+    constexpr auto        QUIET_PERIOD  = std::chrono::milliseconds(1000);
+    constexpr auto        IDLE_DURATION = std::chrono::milliseconds(1000);
+
+    struct LoopResult {
+        std::vector<double> latenessUs;  // From each spell's deadline until it was picked up
+        std::size_t         idleWakeups{0};
+    };
+
+    // Casts CAST_COUNT random spells spread over CAST_SPAN; returns when the last cast was made
+    template <typename Cast>
+    Clock::time_point CastSpells(Cast&& cast) {
+        std::mt19937                               random(42);
+        std::uniform_int_distribution<SpellHandle> spells(0, SPELL_COUNT - 1);
+        const auto                                 startedAt = Clock::now();
+        for (std::size_t i = 0; i < CAST_COUNT; i++) {
+            std::this_thread::sleep_until(startedAt + CAST_SPAN * i / CAST_COUNT);
+            cast(spells(random));
+        }
+        return Clock::now();
+    }
+
+    // The plugin's loop: sleep until the earliest deadline, or until a cast could become due before it
+    LoopResult RunDeadlineLoop() {
+        SpellUseInbox     inbox;
+        DebounceScheduler scheduler(QUIET_PERIOD);
+        inbox.Resize(SPELL_COUNT);
+        scheduler.Resize(SPELL_COUNT);
+
+        std::mutex                mutex;
+        std::condition_variable   cv;
+        std::atomic<bool>         running{true};
+        std::atomic<std::int64_t> idleFromTicks{Clock::time_point::max().time_since_epoch().count()};
+        LoopResult                result;
+
+        std::thread consumer([&] {
+            std::vector<SpellHandle> due;
+            while (running) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    const auto                   sleepUntil = scheduler.Empty() ? Clock::time_point::max() : scheduler.NextDeadline();
+                    if (inbox.BeginSleep(sleepUntil)) {
+                        auto woken = [&] { return !running || !inbox.IsSleeping(); };
+                        if (sleepUntil == Clock::time_point::max()) cv.wait(lock, woken);
+                        else cv.wait_until(lock, sleepUntil, woken);
+                    }
+                    inbox.EndSleep();
+                }
+                if (!running) break;
+
+                const auto now = Clock::now();
+                if (now.time_since_epoch().count() >= idleFromTicks.load()) result.idleWakeups++;
+                inbox.Drain([&](SpellHandle spell, Clock::time_point usedAt) { scheduler.Schedule(spell, usedAt); });
+                due.clear();
+                scheduler.PopDue(now, due);
+                for (auto spell : due) result.latenessUs.push_back(Microseconds(now - (scheduler.LastUse(spell) + QUIET_PERIOD)));
+            }
+        });
+
+        const auto lastCast = CastSpells([&](SpellHandle spell) {
+            const auto now = Clock::now();
+            if (inbox.Record(spell, now, now + scheduler.MinimumDelay(spell))) {
+                std::lock_guard<std::mutex> lock(mutex);
+                cv.notify_one();
+            }
+        });
+
+        // Every deadline has passed once the last cast's quiet period is over; from then on nothing should wake the loop
+        const auto idleFrom = lastCast + QUIET_PERIOD + std::chrono::milliseconds(50);
+        idleFromTicks       = idleFrom.time_since_epoch().count();
+        std::this_thread::sleep_until(idleFrom + IDLE_DURATION);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        cv.notify_one();
+        consumer.join();
+        return result;
+    }
+
+    // The loop this replaced: wake every 100ms, lock the map and scan every spell in it
+    LoopResult RunPollingLoop() {
+        std::mutex                                         mutex;
+        std::unordered_map<SpellHandle, Clock::time_point> lastUseTimes;
+        std::condition_variable                            cv;
+        std::atomic<bool>                                  running{true};
+        std::atomic<std::int64_t>                          idleFromTicks{Clock::time_point::max().time_since_epoch().count()};
+        LoopResult                                         result;
+
+        std::thread consumer([&] {
+            std::vector<SpellHandle> due;
+            while (running) {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait_for(lock, std::chrono::milliseconds(100));
+                if (!running) break;
+
+                const auto now = Clock::now();
+                if (now.time_since_epoch().count() >= idleFromTicks.load()) result.idleWakeups++;
+                for (auto entry = lastUseTimes.begin(); entry != lastUseTimes.end();) {
+                    if (now - entry->second >= QUIET_PERIOD) {
+                        result.latenessUs.push_back(Microseconds(now - (entry->second + QUIET_PERIOD)));
+                        entry = lastUseTimes.erase(entry);
+                    } else {
+                        ++entry;
+                    }
+                }
+            }
+        });
+
+        const auto lastCast = CastSpells([&](SpellHandle spell) {
+            std::lock_guard<std::mutex> lock(mutex);
+            lastUseTimes[spell] = Clock::now();
+        });
+
+        const auto idleFrom = lastCast + QUIET_PERIOD + std::chrono::milliseconds(150);
+        idleFromTicks       = idleFrom.time_since_epoch().count();
+        std::this_thread::sleep_until(idleFrom + IDLE_DURATION);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        cv.notify_one();
+        consumer.join();
+        return result;
+    }
+
+    void ReportLoop(const char* name, LoopResult result) {
+        Report(std::string(name) + ": idle wakeups per second", static_cast<double>(result.idleWakeups) / Seconds(IDLE_DURATION), "wakeups/s");
+        Report(std::string(name) + ": pickup after deadline, p50", Percentile(result.latenessUs, 0.5), "us");
+        Report(std::string(name) + ": pickup after deadline, p99", Percentile(result.latenessUs, 0.99), "us");
+        Report(std::string(name) + ": pickup after deadline, max", Percentile(result.latenessUs, 1.0), "us");
+    }
+}
+
+FORGOTTEN_MAGIC_BENCHMARK(SchedulerWakeups) {
+    ReportLoop("deadline heap", RunDeadlineLoop());
+    ReportLoop("100ms polling", RunPollingLoop());
+}
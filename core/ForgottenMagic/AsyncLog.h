@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "BoundedMpscQueue.h"
+#include "Format.h"
+
+// Log levels below this one (0 = trace, 1 = debug, 2 = info, 3 = warn, 4 = error) are compiled out entirely
+#ifndef FORGOTTEN_MAGIC_MIN_LOG_LEVEL
+    #define FORGOTTEN_MAGIC_MIN_LOG_LEVEL 0
+#endif
+
+namespace ForgottenMagic {
+
+    enum class LogLevel : std::uint8_t { Trace, Debug, Info, Warn, Error, Off };
+
+    // Parses trace, debug, info, warn, error or off
+    inline std::optional<LogLevel> ParseLogLevel(std::string_view name) {
+        constexpr std::array<std::string_view, 6> names = {"trace", "debug", "info", "warn", "error", "off"};
+        for (std::size_t i = 0; i < names.size(); i++) {
+            if (std::ranges::equal(name, names[i], [](char a, char b) { return (a | 0x20) == b; })) return static_cast<LogLevel>(i);
+        }
+        return std::nullopt;
+    }
+
+    namespace LogArguments {
+        // Copy of a string argument, truncated to its first 63 characters so a record never allocates
+        struct InlineString {
+            static constexpr std::size_t CAPACITY = 63;
+
+            std::array<char, CAPACITY> characters;
+            std::uint8_t               length{0};
+
+            InlineString() = default;
+            InlineString(std::string_view value) : length(static_cast<std::uint8_t>(std::min(value.size(), CAPACITY))) { std::memcpy(characters.data(), value.data(), length); }
+            InlineString(const char* value) : InlineString(value ? std::string_view(value) : std::string_view()) {}
+
+            std::string_view View() const { return {characters.data(), length}; }
+        };
+
+        template <typename T>
+        constexpr bool IS_STRING = std::is_convertible_v<const T&, std::string_view> || std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>;
+
+        // How an argument is stored in a log record: strings are copied inline, everything else by value
+        template <typename T>
+        using Captured = std::conditional_t<IS_STRING<std::remove_cvref_t<T>>, InlineString, std::remove_cvref_t<T>>;
+
+        // How an argument is formatted
+        template <typename T>
+        using Formatted = std::conditional_t<IS_STRING<std::remove_cvref_t<T>>, std::string_view, std::remove_cvref_t<T>>;
+
+        template <typename T>
+        decltype(auto) Unwrap(const T& value) {
+            if constexpr (std::is_same_v<T, InlineString>) return value.View();
+            else return (value);
+        }
+    }
+
+    // Format string checked at compile time against the arguments as they will be formatted
+    template <typename... Args>
+    using LogFormat = FormatLibrary::format_string<LogArguments::Formatted<Args>...>;
+
+    /**
+     * Asynchronous logger: callers copy their arguments into a preallocated lock-free ring,
+     * and a writer thread formats them and hands each line to the sink
+     *
+     * Calls below FORGOTTEN_MAGIC_MIN_LOG_LEVEL compile to nothing, and calls below the runtime
+     * level cost one relaxed load. A logging call never blocks or allocates: when the ring is
+     * full the message is dropped and counted, and the writer reports how many were lost.
+     * String arguments are copied inline, so only their first InlineString::CAPACITY (63)
+     * characters are logged.
+     */
+    class AsyncLog {
+    public:
+        static constexpr std::size_t CAPACITY           = 1024;
+        static constexpr std::size_t ARGUMENT_CAPACITY  = 224;
+        static constexpr auto        WRITER_IDLE_PERIOD = std::chrono::milliseconds(50);
+
+        using Sink = std::function<void(LogLevel, std::string_view)>;
+
+    private:
+        using FormatFunction = void (*)(std::string_view format, const std::byte* arguments, std::string& line);
+
+        struct Record {
+            std::string_view                        format;
+            FormatFunction                          formatFunction;
+            LogLevel                                level;
+            std::array<std::byte, ARGUMENT_CAPACITY> arguments;
+        };
+
+        BoundedMpscQueue<Record, CAPACITY> records;
+        std::atomic<LogLevel>              level{LogLevel::Info};
+        std::atomic<std::uint64_t>         dropped{0};
+
+        Sink                    sink;
+        std::thread             writer;
+        std::mutex              writerMutex;
+        std::condition_variable writerCv;
+        std::atomic<bool>       writerSleeping{false};
+        std::atomic<bool>       running{false};
+
+        // The format string's characters; fmt before 10 has no get(), but converts to its own string_view
+        template <typename Format>
+        static std::string_view FormatView(const Format& format) {
+            if constexpr (requires { format.get(); }) {
+                return {format.get().data(), format.get().size()};
+            } else {
+                const FormatLibrary::string_view view = format;
+                return {view.data(), view.size()};
+            }
+        }
+
+        template <typename... Ts>
+        static void FormatTo(std::string& line, std::string_view format, const Ts&... values) {
+            FormatLibrary::vformat_to(std::back_inserter(line), format, FormatLibrary::make_format_args(values...));
+        }
+
+        // Instantiated once per argument list; unpacks a record's arguments and formats them
+        template <typename... Args>
+        static void Format(std::string_view format, const std::byte* arguments, std::string& line) {
+            std::tuple<LogArguments::Captured<Args>...> values;
+            std::size_t                                 offset = 0;
+            std::apply([&](auto&... value) { ((std::memcpy(&value, arguments + offset, sizeof(value)), offset += sizeof(value)), ...); }, values);
+            std::apply([&](const auto&... value) { FormatTo(line, format, LogArguments::Unwrap(value)...); }, values);
+        }
+
+        template <typename T>
+        static void Pack(std::byte* arguments, std::size_t& offset, const T& value) {
+            const LogArguments::Captured<T> captured(value);
+            std::memcpy(arguments + offset, &captured, sizeof(captured));
+            offset += sizeof(captured);
+        }
+
+        void WriteRecords(std::string& line) {
+            Record record;
+            while (records.TryPop(record)) {
+                line.clear();
+                record.formatFunction(record.format, record.arguments.data(), line);
+                sink(record.level, line);
+            }
+            if (auto lost = dropped.exchange(0, std::memory_order_relaxed)) {
+                line.clear();
+                FormatTo(line, "[Log] Dropped {} log messages because the log buffer was full", lost);
+                sink(LogLevel::Warn, line);
+            }
+        }
+
+        void WriterThreadFunction() {
+            std::string line;
+            while (running) {
+                WriteRecords(line);
+
+                // Producers only notify when they see us sleeping; a missed notification just waits out the idle period
+                std::unique_lock<std::mutex> lock(writerMutex);
+                writerSleeping = true;
+                if (running && records.Empty()) writerCv.wait_for(lock, WRITER_IDLE_PERIOD);
+                writerSleeping = false;
+            }
+            WriteRecords(line);
+        }
+
+    public:
+        ~AsyncLog() { Stop(); }
+
+        // Starts the writer thread; messages logged before this are written once it starts
+        void Start(Sink lineSink) {
+            if (writer.joinable()) return;
+            sink    = std::move(lineSink);
+            running = true;
+            writer  = std::thread(&AsyncLog::WriterThreadFunction, this);
+        }
+
+        // Writes every pending message, then stops the writer thread
+        void Stop() {
+            if (!writer.joinable()) return;
+            {
+                std::lock_guard<std::mutex> lock(writerMutex);
+                running = false;
+            }
+            writerCv.notify_all();
+            writer.join();
+        }
+
+        void SetLevel(LogLevel minimumLevel) { level.store(minimumLevel, std::memory_order_relaxed); }
+        LogLevel Level() const { return level.load(std::memory_order_relaxed); }
+
+        template <LogLevel Level, typename... Args>
+        void Write(LogFormat<Args...> format, Args&&... args) {
+            if constexpr (static_cast<int>(Level) >= FORGOTTEN_MAGIC_MIN_LOG_LEVEL) {
+                static_assert((std::is_trivially_copyable_v<LogArguments::Captured<Args>> && ...), "Log arguments must be strings or trivially copyable");
+                static_assert((sizeof(LogArguments::Captured<Args>) + ... + 0) <= ARGUMENT_CAPACITY, "Too many log arguments for one record");
+
+                if (Level < level.load(std::memory_order_relaxed)) return;
+
+                Record record;
+                record.format         = FormatView(format);
+                record.formatFunction = &Format<Args...>;
+                record.level          = Level;
+                std::size_t offset    = 0;
+                (Pack(record.arguments.data(), offset, args), ...);
+
+                if (!records.TryPush(record)) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                if (writerSleeping.load()) writerCv.notify_one();
+            }
+        }
+    };
+}
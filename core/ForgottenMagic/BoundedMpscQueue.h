@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ForgottenMagic {
+
+    /**
+     * Bounded lock-free multi-producer/single-consumer queue
+     *
+     * Each cell carries a sequence number which tells producers whether the cell is free
+     * and the consumer whether it has been published, so pushing is a single CAS on the
+     * enqueue position and popping never touches shared counters at all.
+     *
+     * TryPush fails instead of blocking when the queue is full; callers decide how to
+     * handle the overflow.
+     */
+    template <typename T, std::size_t Capacity>
+    class BoundedMpscQueue {
+        static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            T                        value;
+        };
+
+        std::array<Cell, Capacity> cells;
+
+        // Shared by all producers
+        alignas(64) std::atomic<std::size_t> enqueue_position{0};
+
+        // Only ever touched by the consumer
+        alignas(64) std::size_t dequeue_position{0};
+
+    public:
+        BoundedMpscQueue() {
+            for (std::size_t i = 0; i < Capacity; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        bool TryPush(const T& value) {
+            auto position = enqueue_position.load(std::memory_order_relaxed);
+            while (true) {
+                auto& cell     = cells[position & (Capacity - 1)];
+                auto  sequence = cell.sequence.load(std::memory_order_acquire);
+                auto  diff     = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+                if (diff == 0) {
+                    if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.value = value;
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;  // Full
+                } else {
+                    position = enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool TryPop(T& value) {
+            auto& cell     = cells[dequeue_position & (Capacity - 1)];
+            auto  sequence = cell.sequence.load(std::memory_order_acquire);
+            if (sequence != dequeue_position + 1) return false;  // Empty (or the next producer has not published yet)
+            value = cell.value;
+            cell.sequence.store(dequeue_position + Capacity, std::memory_order_release);
+            dequeue_position++;
+            return true;
+        }
+
+        bool Empty() const { return cells[dequeue_position & (Capacity - 1)].sequence.load(std::memory_order_acquire) != dequeue_position + 1; }
+    };
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "Interfaces.h"
+
+namespace ForgottenMagic {
+
+    /**
+     * How long a spell must go without being cast before it is due
+     *
+     * Fixed waits the same quiet period after every cast. Adaptive sizes the window from the
+     * largest gap seen between a spell's casts within a burst (gapMultiplier times its running
+     * average over past bursts), between minQuietPeriod and quietPeriod. Either can be capped
+     * by maxLatency, which makes a spell due at most that long after the first cast of a burst,
+     * so continuously cast spells are still updated while they are in use.
+     */
+    struct DebouncePolicy {
+        using Clock = std::chrono::steady_clock;
+
+        enum class Window : std::uint8_t { Fixed, Adaptive };
+
+        Window          window{Window::Fixed};
+        Clock::duration quietPeriod{std::chrono::milliseconds(1000)};  // Fixed: the window; Adaptive: the largest window
+        Clock::duration minQuietPeriod{};                              // Adaptive: the smallest window
+        float           gapMultiplier{2.0f};                           // Adaptive
+        Clock::duration maxLatency{};                                  // Zero for no cap
+
+        static DebouncePolicy Fixed(Clock::duration quietPeriod) { return {Window::Fixed, quietPeriod}; }
+
+        static DebouncePolicy MaxLatency(Clock::duration quietPeriod, Clock::duration maxLatency) { return {Window::Fixed, quietPeriod, {}, 2.0f, maxLatency}; }
+
+        static DebouncePolicy Adaptive(Clock::duration minQuietPeriod, Clock::duration quietPeriod, float gapMultiplier) {
+            return {Window::Adaptive, quietPeriod, minQuietPeriod, gapMultiplier};
+        }
+
+        // Shortest time after a cast at which the spell can become due
+        Clock::duration MinimumDelay() const {
+            auto delay = window == Window::Adaptive ? minQuietPeriod : quietPeriod;
+            return maxLatency > Clock::duration::zero() ? std::min(delay, maxLatency) : delay;
+        }
+    };
+
+    /**
+     * Min-heap of per-spell deadlines: a spell becomes due once it has not been cast for its debounce window
+     *
+     * Holds exactly one heap entry per scheduled spell. Within a burst of casts every policy
+     * only ever moves a spell's deadline later, so recasting a scheduled spell only updates the
+     * dense deadline column; its heap entry may then be stale, and is pushed back with the real
+     * deadline when it is popped. So casting never grows the heap, and the owner can sleep until
+     * NextDeadline() without waking up for every cast of an already scheduled spell.
+     *
+     * Not thread-safe: owned by a single consumer thread. Policies must be set before casts are
+     * scheduled, after which MinimumDelay may be read from any thread.
+     */
+    class DebounceScheduler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+    private:
+        struct ScheduledSpell {
+            Clock::time_point deadline;
+            SpellHandle       spell;
+
+            bool operator>(const ScheduledSpell& other) const { return deadline > other.deadline; }
+        };
+
+        // Per-spell debounce state of the current burst of casts
+        struct Burst {
+            Clock::time_point firstUse;
+            Clock::time_point lastUse;
+            Clock::duration   largestGap{};
+        };
+
+        DebouncePolicy defaultPolicy;
+
+        std::vector<DebouncePolicy> policies;
+
+        // Real deadline of each spell, and whether it has an entry in the heap
+        std::vector<Clock::time_point> deadlines;
+        std::vector<std::uint8_t>      scheduled;
+
+        std::vector<Burst> bursts;
+
+        // Adaptive: running average of the largest gap within each of a spell's past bursts
+        std::vector<Clock::duration> typicalLargestGaps;
+
+        std::priority_queue<ScheduledSpell, std::vector<ScheduledSpell>, std::greater<>> heap;
+
+        Clock::duration Window(SpellHandle spell) const {
+            const auto& policy = policies[spell];
+            if (policy.window == DebouncePolicy::Window::Fixed) return policy.quietPeriod;
+
+            const auto largestGap = std::max(typicalLargestGaps[spell], bursts[spell].largestGap);
+            const auto window     = std::chrono::duration_cast<Clock::duration>(largestGap * policy.gapMultiplier);
+            return std::clamp(window, policy.minQuietPeriod, std::max(policy.minQuietPeriod, policy.quietPeriod));
+        }
+
+        // Folds a finished burst into the spell's typical largest gap
+        void FinishBurst(SpellHandle spell) {
+            if (policies[spell].window != DebouncePolicy::Window::Adaptive) return;
+            auto& typical = typicalLargestGaps[spell];
+            typical += (bursts[spell].largestGap - typical) / 4;
+        }
+
+    public:
+        explicit DebounceScheduler(Clock::duration quietPeriod) : defaultPolicy(DebouncePolicy::Fixed(quietPeriod)) {}
+
+        // Gives every spell the default fixed quiet period
+        void Resize(std::size_t spellCount) {
+            policies.assign(spellCount, defaultPolicy);
+            deadlines.assign(spellCount, {});
+            scheduled.assign(spellCount, 0);
+            bursts.assign(spellCount, {});
+            typicalLargestGaps.assign(spellCount, defaultPolicy.quietPeriod);
+            heap = {};
+        }
+
+        void SetPolicy(SpellHandle spell, const DebouncePolicy& policy) {
+            policies[spell] = policy;
+            // Adaptive windows start at their largest until the spell's casts have been observed
+            typicalLargestGaps[spell] = policy.quietPeriod;
+        }
+
+        const DebouncePolicy& Policy(SpellHandle spell) const { return policies[spell]; }
+
+        Clock::duration MinimumDelay(SpellHandle spell) const { return policies[spell].MinimumDelay(); }
+
+        // Records a cast, pushing the spell's deadline back to a debounce window after it
+        void Schedule(SpellHandle spell, Clock::time_point usedAt) {
+            auto& burst = bursts[spell];
+            if (scheduled[spell]) {
+                // Only gaps between casts within a burst say anything about how the spell is cast
+                if (usedAt > burst.lastUse) {
+                    burst.largestGap = std::max(burst.largestGap, usedAt - burst.lastUse);
+                    burst.lastUse    = usedAt;
+                }
+            } else {
+                burst = {usedAt, usedAt, {}};
+            }
+
+            auto        deadline   = burst.lastUse + Window(spell);
+            const auto& maxLatency = policies[spell].maxLatency;
+            if (maxLatency > Clock::duration::zero()) deadline = std::min(deadline, burst.firstUse + maxLatency);
+
+            auto& currentDeadline = deadlines[spell];
+            if (scheduled[spell]) {
+                if (deadline > currentDeadline) currentDeadline = deadline;
+                return;
+            }
+
+            currentDeadline  = deadline;
+            scheduled[spell] = 1;
+            heap.push({deadline, spell});
+        }
+
+        bool Empty() const { return heap.empty(); }
+
+        // Earliest time at which a spell may be due; only valid when not Empty()
+        Clock::time_point NextDeadline() const { return heap.top().deadline; }
+
+        // Latest cast of the spell scheduled so far
+        Clock::time_point LastUse(SpellHandle spell) const { return bursts[spell].lastUse; }
+
+        // Appends every spell whose deadline has passed to due, and stops tracking them
+        void PopDue(Clock::time_point now, std::vector<SpellHandle>& due) {
+            while (!heap.empty() && heap.top().deadline <= now) {
+                auto spell = heap.top().spell;
+                heap.pop();
+
+                // The spell was cast again after this entry was pushed, so put it back with its real deadline
+                if (deadlines[spell] > now) {
+                    heap.push({deadlines[spell], spell});
+                    continue;
+                }
+
+                due.push_back(spell);
+                scheduled[spell] = 0;
+                FinishBurst(spell);
+            }
+        }
+
+        std::size_t ScheduledCount() const { return heap.size(); }
+    };
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace ForgottenMagic {
+
+    /**
+     * Bitmaps of tracked effect FormIDs, one per plugin the effects come from
+     *
+     * Lets the event path reject every other effect with a search over a handful of blocks,
+     * one range check and no lookups. Effects from different plugins have FormIDs far apart
+     * (the load order index is the top byte, or the top 20 bits for light plugins), so each
+     * plugin gets its own [base, base + range) bitmap instead of one spanning the gap.
+     *
+     * Rank also numbers the tracked FormIDs densely, in ascending order, by counting the set
+     * bits before each one, so a host can keep a plain array of values per tracked effect.
+     */
+    class EffectFilter {
+        struct Block {
+            std::uint32_t prefix;
+            std::uint32_t base;
+            std::uint32_t range;
+            std::size_t   firstWord;
+        };
+
+        // Sorted by prefix
+        std::vector<Block>         blocks;
+        std::vector<std::uint64_t> bits;
+
+        // Set bits in all words before each word
+        std::vector<std::uint32_t> ranks;
+
+        // Identifies the plugin a FormID belongs to; light plugin prefixes (0xFE000 and up) never collide with full ones
+        static std::uint32_t Prefix(std::uint32_t formID) { return (formID >> 24) == 0xFE ? formID >> 12 : formID >> 24; }
+
+    public:
+        void Build(std::span<const std::uint32_t> effectFormIDs) {
+            blocks.clear();
+            bits.clear();
+            ranks.clear();
+
+            std::vector<std::uint32_t> sorted(effectFormIDs.begin(), effectFormIDs.end());
+            std::ranges::sort(sorted);
+            for (auto first = sorted.begin(); first != sorted.end();) {
+                const auto prefix = Prefix(*first);
+                const auto last   = std::find_if(first, sorted.end(), [prefix](std::uint32_t formID) { return Prefix(formID) != prefix; });
+
+                Block block{prefix, *first, *(last - 1) - *first + 1, bits.size()};
+                bits.resize(bits.size() + (block.range + 63) / 64, 0);
+                for (auto formID = first; formID != last; formID++) {
+                    const auto offset = *formID - block.base;
+                    bits[block.firstWord + (offset >> 6)] |= std::uint64_t{1} << (offset & 63);
+                }
+                blocks.push_back(block);
+                first = last;
+            }
+
+            // Blocks are in prefix order, which is FormID order, so ranks ascend with the FormIDs
+            std::uint32_t rank = 0;
+            for (const auto word : bits) {
+                ranks.push_back(rank);
+                rank += static_cast<std::uint32_t>(std::popcount(word));
+            }
+        }
+
+        bool Contains(std::uint32_t effectFormID) const {
+            const auto prefix = Prefix(effectFormID);
+            const auto block  = std::ranges::lower_bound(blocks, prefix, {}, &Block::prefix);
+            if (block == blocks.end() || block->prefix != prefix) return false;
+
+            // Unsigned wraparound makes anything below the base fall outside the range too
+            const auto offset = effectFormID - block->base;
+            if (offset >= block->range) return false;
+            return (bits[block->firstWord + (offset >> 6)] >> (offset & 63)) & 1;
+        }
+
+        // Position of a tracked FormID among the distinct tracked FormIDs, in ascending order; nullopt if it is not tracked
+        std::optional<std::uint32_t> Rank(std::uint32_t effectFormID) const {
+            const auto prefix = Prefix(effectFormID);
+            const auto block  = std::ranges::lower_bound(blocks, prefix, {}, &Block::prefix);
+            if (block == blocks.end() || block->prefix != prefix) return std::nullopt;
+
+            const auto offset = effectFormID - block->base;
+            if (offset >= block->range) return std::nullopt;
+            const auto word = block->firstWord + (offset >> 6);
+            const auto bit  = std::uint64_t{1} << (offset & 63);
+            if (!(bits[word] & bit)) return std::nullopt;
+            return ranks[word] + static_cast<std::uint32_t>(std::popcount(bits[word] & (bit - 1)));
+        }
+
+        // Number of FormIDs the bitmaps span
+        std::uint32_t Range() const {
+            std::uint32_t range = 0;
+            for (const auto& block : blocks) range += block.range;
+            return range;
+        }
+    };
+}
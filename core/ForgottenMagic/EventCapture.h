@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+#include "Interfaces.h"
+
+namespace ForgottenMagic {
+
+    /**
+     * Binary capture of a stream of magic effect events, for replaying outside the game
+     *
+     * Layout (native endianness):
+     *   Header
+     *   Effect[header.effectCount]: every tracked effect and the spell handle it belongs to
+     *   Record[header.recordCapacity]: the events, in the order they were appended
+     *
+     * The file is preallocated and zero-filled. recordCount is written when the capture is
+     * closed; a capture which was never closed (e.g. the game crashed) is read up to its first
+     * empty record instead.
+     */
+    namespace EventCapture {
+        constexpr std::uint32_t MAGIC   = 0x4345'4D46;  // "FMEC"
+        constexpr std::uint32_t VERSION = 1;
+
+        struct Header {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::uint32_t effectCount;
+            std::uint32_t reserved;
+            std::uint64_t recordCapacity;
+            std::uint64_t recordCount;
+        };
+
+        struct Effect {
+            std::uint32_t effectFormID;
+            SpellHandle   spell;
+        };
+
+        struct Record {
+            std::uint64_t timestampNs;   // Since the capture was opened
+            std::uint32_t effectFormID;  // Never 0 for a written record
+            std::uint32_t casterFormID;  // 0 if none
+            std::uint32_t targetFormID;  // 0 if none
+            std::uint32_t reserved;
+        };
+
+        constexpr std::size_t RecordsOffset(std::size_t effectCount) { return sizeof(Header) + effectCount * sizeof(Effect); }
+
+        struct Capture {
+            std::vector<Effect> effects;
+            std::vector<Record> records;
+        };
+
+        inline std::optional<Capture> Load(const std::filesystem::path& path) {
+            std::ifstream file(path, std::ios::binary);
+            Header        header;
+            if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return std::nullopt;
+            if (header.magic != MAGIC || header.version != VERSION) return std::nullopt;
+
+            Capture capture;
+            capture.effects.resize(header.effectCount);
+            if (!file.read(reinterpret_cast<char*>(capture.effects.data()), static_cast<std::streamsize>(capture.effects.size() * sizeof(Effect)))) return std::nullopt;
+
+            // Unclosed captures have no record count, so read until the first empty record
+            const auto closed = header.recordCount != 0;
+            const auto count  = closed ? header.recordCount : header.recordCapacity;
+            Record     record;
+            for (std::uint64_t i = 0; i < count && file.read(reinterpret_cast<char*>(&record), sizeof(record)); i++) {
+                if (!closed && record.effectFormID == 0) break;
+                capture.records.push_back(record);
+            }
+            return capture;
+        }
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+// Text is formatted with std::format, or with the fmt library where the standard library has no <format> (g++ 12)
+#if defined(FORGOTTEN_MAGIC_USE_FMT)
+    #include <fmt/format.h>
+#elif __has_include(<format>)
+    #include <format>
+#else
+    #error "ForgottenMagic needs <format>, which this standard library does not have: build with the fmt library instead (xmake f --fmt=y)"
+#endif
+
+namespace ForgottenMagic {
+
+#if defined(FORGOTTEN_MAGIC_USE_FMT)
+    namespace FormatLibrary = ::fmt;
+#else
+    namespace FormatLibrary = ::std;
+#endif
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Interfaces.h"
+#include "XpSnapshot.h"
+
+namespace ForgottenMagic {
+
+    // XP source backed by a plain table indexed by SpellIndex, standing in for the game's Papyrus arrays
+    class InMemoryXpSource : public IXpSource {
+    public:
+        struct Entry {
+            float        xp{0.0f};
+            float        xpReq{1.0f};
+            std::int32_t points{0};
+        };
+
+        std::vector<Entry> entries;
+
+        bool Capture(XpSnapshot& snapshot) override {
+            snapshot.Reset(entries.size());
+            for (SpellIndex spellIndex = 0; spellIndex < entries.size(); spellIndex++) CopyEntry(snapshot, spellIndex);
+            return true;
+        }
+
+        bool Capture(XpSnapshot& snapshot, std::span<const SpellIndex> spellIndexes) override {
+            snapshot.Reset(entries.size(), spellIndexes);
+            for (const auto spellIndex : spellIndexes)
+                if (spellIndex < entries.size()) CopyEntry(snapshot, spellIndex);
+            return true;
+        }
+
+    private:
+        void CopyEntry(XpSnapshot& snapshot, SpellIndex spellIndex) const {
+            snapshot.SetXp(spellIndex, entries[spellIndex].xp);
+            snapshot.SetXpReq(spellIndex, entries[spellIndex].xpReq);
+            snapshot.SetPoints(spellIndex, entries[spellIndex].points);
+            snapshot.MarkPresent(spellIndex);
+        }
+    };
+
+    // Name sink which records the latest name of each spell, standing in for renaming the game's forms
+    class InMemoryNameSink : public INameSink {
+    public:
+        std::vector<std::string> names;
+        std::uint64_t            renameCount{0};
+
+        void SetName(SpellHandle spell, const char* name) override {
+            if (spell >= names.size()) names.resize(spell + 1);
+            names[spell] = name;
+            renameCount++;
+        }
+    };
+}
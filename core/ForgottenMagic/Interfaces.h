@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace ForgottenMagic {
+
+    // Identifies a tracked spell: its slot in the host's spell registry
+    using SpellHandle = std::uint32_t;
+
+    // Position of a spell in the progression mod's XP and points arrays
+    using SpellIndex = std::uint32_t;
+
+    class XpSnapshot;
+
+    /**
+     * Where the spells' XP, XP requirements and available points come from
+     *
+     * In the game this is the MCM script's Papyrus arrays; on the host it is an in-memory table.
+     */
+    class IXpSource {
+    public:
+        virtual ~IXpSource() = default;
+
+        /**
+         * Copies every spell index's raw values into the snapshot
+         *
+         * @return false if no data is available at all, in which case the batch is skipped
+         */
+        virtual bool Capture(XpSnapshot& snapshot) = 0;
+
+        /**
+         * Copies only the given spell indexes' raw values, for a batch of a few spells
+         *
+         * The snapshot is sized as by a full capture, but its other lanes are left as they were.
+         */
+        virtual bool Capture(XpSnapshot& snapshot, std::span<const SpellIndex> spellIndexes) = 0;
+    };
+
+    /**
+     * Where rendered spell names go
+     *
+     * In the game this renames the SpellItem; on the host it records the names.
+     */
+    class INameSink {
+    public:
+        virtual ~INameSink() = default;
+
+        // The name is only valid for the duration of the call
+        virtual void SetName(SpellHandle spell, const char* name) = 0;
+    };
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "Interfaces.h"
+
+namespace ForgottenMagic {
+
+    /**
+     * HDR-style bucketing for latencies in microseconds
+     *
+     * Values below 16 get exact buckets; above that every power of two is split into 16
+     * linear sub-buckets, so any recorded value is reported within ~6% of its real value,
+     * up to 2^40 microseconds.
+     */
+    struct LatencyBuckets {
+        static constexpr unsigned    SUB_BUCKET_BITS = 4;
+        static constexpr unsigned    SUB_BUCKETS     = 1u << SUB_BUCKET_BITS;
+        static constexpr unsigned    MAX_EXPONENT    = 40;
+        static constexpr std::size_t COUNT           = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+        static std::size_t Index(std::uint64_t micros) {
+            if (micros < SUB_BUCKETS) return static_cast<std::size_t>(micros);
+            const auto exponent = std::min<unsigned>(static_cast<unsigned>(std::bit_width(micros)) - 1, MAX_EXPONENT);
+            const auto subBucket = static_cast<std::size_t>((micros >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+            return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket;
+        }
+
+        // Largest value which falls into the bucket
+        static std::uint64_t UpperBound(std::size_t index) {
+            if (index < SUB_BUCKETS) return index;
+            const auto exponent  = static_cast<unsigned>(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+            const auto subBucket = static_cast<std::uint64_t>(index % SUB_BUCKETS);
+            return ((SUB_BUCKETS + subBucket + 1) << (exponent - SUB_BUCKET_BITS)) - 1;
+        }
+    };
+
+    /**
+     * Coarse power-of-two bucketing for per-spell latencies in microseconds
+     *
+     * Bucket i holds values below 2^i, so a reported value is within 2x of the real one; per
+     * spell this is enough to tell a spell picked up in milliseconds from one waiting seconds.
+     */
+    struct SpellLatencyBuckets {
+        static constexpr std::size_t COUNT = 32;
+
+        static std::size_t Index(std::uint64_t micros) { return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(micros)), COUNT - 1); }
+
+        // Largest value which falls into the bucket
+        static std::uint64_t UpperBound(std::size_t index) { return index == 0 ? 0 : (std::uint64_t{1} << index) - 1; }
+    };
+
+    /**
+     * Runtime counters and latency histograms for the cast → rename pipeline
+     *
+     * Every thread records into its own block, so recording is a relaxed load and store with
+     * no contention; a reader sums the blocks. When disabled, each recording call is a single
+     * relaxed load and branch, so this stays compiled into release builds.
+     *
+     * Cast-to-pickup latency is also kept per spell, in coarser buckets, which a thread only
+     * allocates once it records its first pickup.
+     *
+     * A reporter thread writes a compact JSON summary every flush interval and when stopped.
+     */
+    class Metrics {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        enum Counter : std::size_t {
+            EVENTS_SEEN,     // Every magic effect event, tracked or not
+            EVENTS_TRACKED,  // Events for tracked spells
+            BATCHES,
+            RENAMES,
+            XP_RECONCILES,  // XP mirror reconciliations with the authoritative arrays
+            XP_DRIFTS,      // Spells whose mirrored XP was found wrong and corrected
+            XP_PUSHES,      // Spells the MCM script reported as changed through the Papyrus API
+            COUNTER_COUNT
+        };
+
+        enum Histogram : std::size_t {
+            CAST_TO_PICKUP,  // From a spell's last cast until the background thread picks it up
+            BATCH_DURATION,  // Time spent processing a batch
+            HISTOGRAM_COUNT
+        };
+
+    private:
+        // Owned and written by exactly one thread, read by the reporter
+        struct ThreadBlock {
+            std::array<std::atomic<std::uint64_t>, COUNTER_COUNT>                                    counters{};
+            std::array<std::array<std::atomic<std::uint64_t>, LatencyBuckets::COUNT>, HISTOGRAM_COUNT> histograms{};
+            std::unique_ptr<std::atomic<std::uint64_t>[]>                                            eventsBySpell;
+            std::unique_ptr<std::atomic<std::uint64_t>[]>                                            renamesBySpell;
+
+            // spellCount * SpellLatencyBuckets::COUNT pickup buckets, published once allocated by the owning thread
+            std::unique_ptr<std::atomic<std::uint64_t>[]> pickupsBySpellStorage;
+            std::atomic<std::atomic<std::uint64_t>*>      pickupsBySpell{nullptr};
+        };
+
+        static std::uint64_t Micros(Clock::duration latency) {
+            const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+            return micros > 0 ? static_cast<std::uint64_t>(micros) : 0;
+        }
+
+        // Single-writer increment, cheaper than fetch_add
+        static void Increment(std::atomic<std::uint64_t>& value) { value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+        std::atomic<bool> enabled{false};
+        std::size_t       spellCount{0};
+
+        std::mutex                                blocksMutex;
+        std::vector<std::unique_ptr<ThreadBlock>> blocks;
+
+        // Reporter
+        std::vector<std::string> spellLabels;
+        std::filesystem::path    outputPath;
+        Clock::duration          flushInterval{};
+        Clock::time_point        startedAt;
+        std::thread              reporter;
+        std::mutex               reporterMutex;
+        std::condition_variable  reporterCv;
+        bool                     stopping{false};
+
+        ThreadBlock& Local() {
+            thread_local const Metrics* owner = nullptr;
+            thread_local ThreadBlock*   block = nullptr;
+            if (owner != this) {
+                auto newBlock            = std::make_unique<ThreadBlock>();
+                newBlock->eventsBySpell  = std::make_unique<std::atomic<std::uint64_t>[]>(spellCount);
+                newBlock->renamesBySpell = std::make_unique<std::atomic<std::uint64_t>[]>(spellCount);
+                block                    = newBlock.get();
+                owner                    = this;
+                std::lock_guard<std::mutex> lock(blocksMutex);
+                blocks.push_back(std::move(newBlock));
+            }
+            return *block;
+        }
+
+        void ReporterThreadFunction() {
+            std::unique_lock<std::mutex> lock(reporterMutex);
+            while (!reporterCv.wait_for(lock, flushInterval, [this] { return stopping; })) WriteSummaryFile();
+            WriteSummaryFile();
+        }
+
+        static void WriteJsonString(std::ostream& out, std::string_view value) {
+            out << '"';
+            for (auto character : value) {
+                if (character == '"' || character == '\\') out << '\\';
+                out << character;
+            }
+            out << '"';
+        }
+
+        void WriteSummaryFile() {
+            auto temporaryPath = outputPath;
+            temporaryPath += ".tmp";
+            {
+                std::ofstream file(temporaryPath, std::ios::trunc);
+                if (!file) return;
+                WriteJson(file);
+                if (!file) return;
+            }
+            std::error_code error;
+            std::filesystem::rename(temporaryPath, outputPath, error);
+        }
+
+    public:
+        ~Metrics() { Stop(); }
+
+        /**
+         * Enables or disables recording
+         *
+         * Must be called before any thread records, with the number of spell handles to track.
+         */
+        void Configure(bool enable, std::size_t trackedSpellCount) {
+            spellCount = trackedSpellCount;
+            startedAt  = Clock::now();
+            enabled.store(enable, std::memory_order_relaxed);
+        }
+
+        bool Enabled() const { return enabled.load(std::memory_order_relaxed); }
+
+        void Count(Counter counter) {
+            if (!Enabled()) return;
+            Increment(Local().counters[counter]);
+        }
+
+        void Add(Counter counter, std::uint64_t amount) {
+            if (!Enabled()) return;
+            auto& value = Local().counters[counter];
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        void CountEvent(SpellHandle spell) {
+            if (!Enabled()) return;
+            auto& block = Local();
+            Increment(block.counters[EVENTS_TRACKED]);
+            if (spell < spellCount) Increment(block.eventsBySpell[spell]);
+        }
+
+        void CountRename(SpellHandle spell) {
+            if (!Enabled()) return;
+            auto& block = Local();
+            Increment(block.counters[RENAMES]);
+            if (spell < spellCount) Increment(block.renamesBySpell[spell]);
+        }
+
+        void Record(Histogram histogram, Clock::duration latency) {
+            if (!Enabled()) return;
+            Increment(Local().histograms[histogram][LatencyBuckets::Index(Micros(latency))]);
+        }
+
+        // Records a spell's cast-to-pickup latency, in aggregate and for the spell
+        void RecordPickup(SpellHandle spell, Clock::duration latency) {
+            if (!Enabled()) return;
+            auto&      block  = Local();
+            const auto micros = Micros(latency);
+            Increment(block.histograms[CAST_TO_PICKUP][LatencyBuckets::Index(micros)]);
+            if (spell >= spellCount) return;
+
+            auto* pickups = block.pickupsBySpell.load(std::memory_order_relaxed);
+            if (!pickups) {
+                block.pickupsBySpellStorage = std::make_unique<std::atomic<std::uint64_t>[]>(spellCount * SpellLatencyBuckets::COUNT);
+                pickups                     = block.pickupsBySpellStorage.get();
+                block.pickupsBySpell.store(pickups, std::memory_order_release);
+            }
+            Increment(pickups[spell * SpellLatencyBuckets::COUNT + SpellLatencyBuckets::Index(micros)]);
+        }
+
+        /**
+         * Starts writing the summary to a file every flush interval
+         *
+         * @param labels Name of each spell handle in the summary
+         */
+        void StartReporter(std::filesystem::path path, Clock::duration interval, std::vector<std::string> labels) {
+            if (!Enabled() || reporter.joinable()) return;
+            outputPath    = std::move(path);
+            flushInterval = interval;
+            spellLabels   = std::move(labels);
+            reporter      = std::thread(&Metrics::ReporterThreadFunction, this);
+        }
+
+        // Stops the reporter, which writes one final summary
+        void Stop() {
+            if (!reporter.joinable()) return;
+            {
+                std::lock_guard<std::mutex> lock(reporterMutex);
+                stopping = true;
+            }
+            reporterCv.notify_all();
+            reporter.join();
+        }
+
+        // Writes totals, rates, latency percentiles and per-spell counts and pickup latencies as one JSON object
+        void WriteJson(std::ostream& out) {
+            std::array<std::uint64_t, COUNTER_COUNT>                                         counters{};
+            std::array<std::array<std::uint64_t, LatencyBuckets::COUNT>, HISTOGRAM_COUNT> histograms{};
+            std::vector<std::uint64_t>                                                       eventsBySpell(spellCount), renamesBySpell(spellCount);
+            std::vector<std::uint64_t>                                                       pickupsBySpell(spellCount * SpellLatencyBuckets::COUNT);
+            {
+                std::lock_guard<std::mutex> lock(blocksMutex);
+                for (const auto& block : blocks) {
+                    for (std::size_t i = 0; i < COUNTER_COUNT; i++) counters[i] += block->counters[i].load(std::memory_order_relaxed);
+                    for (std::size_t h = 0; h < HISTOGRAM_COUNT; h++)
+                        for (std::size_t i = 0; i < LatencyBuckets::COUNT; i++) histograms[h][i] += block->histograms[h][i].load(std::memory_order_relaxed);
+                    for (std::size_t i = 0; i < spellCount; i++) {
+                        eventsBySpell[i] += block->eventsBySpell[i].load(std::memory_order_relaxed);
+                        renamesBySpell[i] += block->renamesBySpell[i].load(std::memory_order_relaxed);
+                    }
+                    if (const auto* pickups = block->pickupsBySpell.load(std::memory_order_acquire))
+                        for (std::size_t i = 0; i < pickupsBySpell.size(); i++) pickupsBySpell[i] += pickups[i].load(std::memory_order_relaxed);
+                }
+            }
+
+            const auto seconds = std::max(std::chrono::duration<double>(Clock::now() - startedAt).count(), 1e-9);
+            out << "{\"uptime_s\":" << seconds;
+            out << ",\"events_seen\":" << counters[EVENTS_SEEN] << ",\"events_tracked\":" << counters[EVENTS_TRACKED];
+            out << ",\"events_seen_per_s\":" << counters[EVENTS_SEEN] / seconds << ",\"events_tracked_per_s\":" << counters[EVENTS_TRACKED] / seconds;
+            out << ",\"batches\":" << counters[BATCHES] << ",\"renames\":" << counters[RENAMES];
+            out << ",\"xp_reconciles\":" << counters[XP_RECONCILES] << ",\"xp_drifts\":" << counters[XP_DRIFTS]
+                << ",\"xp_pushes\":" << counters[XP_PUSHES];
+
+            constexpr const char* histogramNames[HISTOGRAM_COUNT] = {"cast_to_pickup_us", "batch_duration_us"};
+            for (std::size_t h = 0; h < HISTOGRAM_COUNT; h++) {
+                std::uint64_t total = 0;
+                for (auto count : histograms[h]) total += count;
+
+                // Upper bound of the bucket holding the given fraction of samples
+                auto percentile = [&](double fraction) -> std::uint64_t {
+                    if (total == 0) return 0;
+                    const auto    rank = static_cast<std::uint64_t>(fraction * static_cast<double>(total - 1)) + 1;
+                    std::uint64_t seen = 0;
+                    for (std::size_t i = 0; i < LatencyBuckets::COUNT; i++) {
+                        seen += histograms[h][i];
+                        if (seen >= rank) return LatencyBuckets::UpperBound(i);
+                    }
+                    return LatencyBuckets::UpperBound(LatencyBuckets::COUNT - 1);
+                };
+                out << ",\"" << histogramNames[h] << "\":{\"count\":" << total << ",\"p50\":" << percentile(0.5) << ",\"p90\":" << percentile(0.9)
+                    << ",\"p99\":" << percentile(0.99) << ",\"max\":" << percentile(1.0) << "}";
+            }
+
+            out << ",\"spells\":[";
+            auto first = true;
+            for (std::size_t i = 0; i < spellCount; i++) {
+                const std::span<const std::uint64_t> pickups(pickupsBySpell.data() + i * SpellLatencyBuckets::COUNT, SpellLatencyBuckets::COUNT);
+                std::uint64_t                        pickupCount = 0;
+                for (auto count : pickups) pickupCount += count;
+                if (!eventsBySpell[i] && !renamesBySpell[i] && !pickupCount) continue;
+
+                auto pickupPercentile = [&](double fraction) -> std::uint64_t {
+                    const auto    rank = static_cast<std::uint64_t>(fraction * static_cast<double>(pickupCount - 1)) + 1;
+                    std::uint64_t seen = 0;
+                    for (std::size_t bucket = 0; bucket < pickups.size(); bucket++) {
+                        seen += pickups[bucket];
+                        if (seen >= rank) return SpellLatencyBuckets::UpperBound(bucket);
+                    }
+                    return SpellLatencyBuckets::UpperBound(SpellLatencyBuckets::COUNT - 1);
+                };
+
+                if (!first) out << ",";
+                first = false;
+                out << "{\"spell\":";
+                WriteJsonString(out, i < spellLabels.size() ? spellLabels[i] : std::to_string(i));
+                out << ",\"events\":" << eventsBySpell[i] << ",\"renames\":" << renamesBySpell[i];
+                if (pickupCount) out << ",\"cast_to_pickup_us\":{\"count\":" << pickupCount << ",\"p50\":" << pickupPercentile(0.5) << ",\"p99\":" << pickupPercentile(0.99) << "}";
+                out << "}";
+            }
+            out << "]}\n";
+        }
+    };
+}
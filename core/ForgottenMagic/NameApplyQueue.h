@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Interfaces.h"
+
+namespace ForgottenMagic {
+
+    /**
+     * Hands renames from the background pipeline to the thread which owns the spells' names
+     *
+     * SetName (any thread) only records the spell's latest name; a spell renamed again before
+     * its pending name was applied keeps just the newest one. The owning thread calls
+     * ApplyPending once per frame, which applies pending names in the order their spells were
+     * first posted, stopping once the frame budget is spent (after at least one name); the rest
+     * wait for the next frame.
+     *
+     * ApplyPending must be driven by a real frame boundary: a task queue which runs the tasks
+     * its tasks add before returning (as the SKSE task interface does) would apply everything
+     * in one frame if the queue re-posted itself.
+     */
+    class NameApplyQueue : public INameSink {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+    private:
+        std::mutex mutex;
+
+        // Latest pending name of each spell, by handle, and the spells with a pending name in posting order
+        std::vector<std::string>  pendingNames;
+        std::vector<std::uint8_t> pending;
+        std::vector<SpellHandle>  order;
+        std::size_t               orderHead{0};
+
+        // Whether any name is pending, so an idle frame does not take the mutex
+        std::atomic<bool> hasPending{false};
+
+        INameSink*      target{nullptr};
+        Clock::duration frameBudget{};
+
+        std::uint64_t coalesced{0};
+        std::uint64_t applied{0};
+        std::uint64_t frames{0};
+
+        // Only used by the owning thread while applying
+        std::string applyingName;
+
+    public:
+        /**
+         * @param applySink Renames the spells on the thread which owns the names
+         * @param budget Time each frame may spend applying names
+         */
+        void Configure(std::size_t spellCount, INameSink& applySink, Clock::duration budget) {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendingNames.assign(spellCount, {});
+            pending.assign(spellCount, 0);
+            order.clear();
+            order.reserve(spellCount);
+            orderHead   = 0;
+            target      = &applySink;
+            frameBudget = budget;
+            hasPending.store(false, std::memory_order_relaxed);
+        }
+
+        // Records a spell's new name (any thread, never waits for the owning thread)
+        void SetName(SpellHandle spell, const char* name) override {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (spell >= pending.size()) return;
+            if (pending[spell]) {
+                coalesced++;
+            } else {
+                pending[spell] = 1;
+                order.push_back(spell);
+            }
+            pendingNames[spell].assign(name);
+            hasPending.store(true, std::memory_order_release);
+        }
+
+        // Applies pending names until the frame budget is spent (owning thread, once per frame)
+        void ApplyPending() {
+            if (!hasPending.load(std::memory_order_acquire)) return;
+
+            const auto  started          = Clock::now();
+            std::size_t appliedThisFrame = 0;
+            while (true) {
+                SpellHandle spell;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (orderHead == order.size()) {
+                        order.clear();
+                        orderHead = 0;
+                        hasPending.store(false, std::memory_order_relaxed);
+                        frames++;
+                        return;
+                    }
+                    if (appliedThisFrame > 0 && Clock::now() - started >= frameBudget) {
+                        // Drop the applied prefix so order stays bounded while names keep being posted; the rest waits for the next frame
+                        order.erase(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(orderHead));
+                        orderHead = 0;
+                        frames++;
+                        return;
+                    }
+                    spell          = order[orderHead++];
+                    pending[spell] = 0;
+                    applyingName.swap(pendingNames[spell]);
+                    applied++;
+                }
+                appliedThisFrame++;
+                target->SetName(spell, applyingName.c_str());
+            }
+        }
+
+        std::size_t PendingCount() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return order.size() - orderHead;
+        }
+
+        // Renames replaced by a newer name before being applied, names applied, and frames spent applying
+        std::uint64_t Coalesced() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return coalesced;
+        }
+        std::uint64_t Applied() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return applied;
+        }
+        std::uint64_t Frames() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return frames;
+        }
+    };
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Interfaces.h"
+
+namespace ForgottenMagic {
+
+    /**
+     * Compact, versioned encoding of the last rendered (progress, points) of every spell showing
+     * a progress name, grouped by progression source, for saving alongside a game save
+     *
+     * Spells are identified by source name and SpellIndex, which stay the same across sessions
+     * and INI changes that keep the source. Layout (native endianness), VERSION 1:
+     *   u32 sourceCount
+     *   per source: u32 nameLength, name bytes, u32 entryCount, Entry[entryCount]
+     */
+    namespace RenderedNames {
+        constexpr std::uint32_t VERSION = 1;
+
+        struct Entry {
+            SpellIndex    spellIndex;
+            std::uint16_t points;
+            std::uint8_t  progress;  // 0-100
+            std::uint8_t  reserved;
+        };
+
+        struct Source {
+            std::string        name;
+            std::vector<Entry> entries;
+        };
+
+        inline std::vector<std::byte> Encode(std::span<const Source> sources) {
+            std::vector<std::byte> bytes;
+            auto                   append = [&bytes](const void* data, std::size_t size) {
+                const auto offset = bytes.size();
+                bytes.resize(offset + size);
+                if (size) std::memcpy(bytes.data() + offset, data, size);
+            };
+
+            const auto sourceCount = static_cast<std::uint32_t>(sources.size());
+            append(&sourceCount, sizeof(sourceCount));
+            for (const auto& source : sources) {
+                const auto nameLength = static_cast<std::uint32_t>(source.name.size());
+                const auto entryCount = static_cast<std::uint32_t>(source.entries.size());
+                append(&nameLength, sizeof(nameLength));
+                append(source.name.data(), nameLength);
+                append(&entryCount, sizeof(entryCount));
+                append(source.entries.data(), entryCount * sizeof(Entry));
+            }
+            return bytes;
+        }
+
+        // Returns nullopt for an unknown version or truncated data
+        inline std::optional<std::vector<Source>> Decode(std::span<const std::byte> bytes, std::uint32_t version) {
+            if (version != VERSION) return std::nullopt;
+
+            std::size_t offset = 0;
+            auto        read   = [&](void* data, std::size_t size) {
+                if (bytes.size() - offset < size) return false;
+                if (size) std::memcpy(data, bytes.data() + offset, size);
+                offset += size;
+                return true;
+            };
+
+            std::uint32_t sourceCount;
+            if (!read(&sourceCount, sizeof(sourceCount))) return std::nullopt;
+
+            std::vector<Source> sources;
+            for (std::uint32_t i = 0; i < sourceCount; i++) {
+                Source        source;
+                std::uint32_t nameLength, entryCount;
+                if (!read(&nameLength, sizeof(nameLength)) || bytes.size() - offset < nameLength) return std::nullopt;
+                source.name.assign(reinterpret_cast<const char*>(bytes.data() + offset), nameLength);
+                offset += nameLength;
+                if (!read(&entryCount, sizeof(entryCount)) || (bytes.size() - offset) / sizeof(Entry) < entryCount) return std::nullopt;
+                source.entries.resize(entryCount);
+                read(source.entries.data(), entryCount * sizeof(Entry));
+                sources.push_back(std::move(source));
+            }
+            return sources;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+namespace ForgottenMagic {
+
+    /**
+     * Renders a spell's display name from its original name, progress and available points
+     *
+     * Remembers the last rendered (progress, points) so spells whose state has not changed
+     * are skipped, and renders into a buffer which is reserved up front so that re-rendering
+     * a spell does not allocate.
+     */
+    class SpellNameRenderer {
+        // Extra room reserved past the original name for " (100%)" and a few points
+        static constexpr std::size_t RESERVED_SUFFIX_LENGTH = 32;
+
+        static constexpr std::int32_t NOT_RENDERED = -1;
+
+        std::int32_t  lastProgress{NOT_RENDERED};
+        std::uint32_t lastPoints{0};
+        std::string   buffer;
+
+    public:
+        void Reserve(std::string_view originalName) { buffer.reserve(originalName.size() + RESERVED_SUFFIX_LENGTH); }
+
+        /**
+         * Renders "<original name> (<progress>%)<one * per point>", omitting the progress when it is 0
+         *
+         * @return The rendered name, or nullptr if it is the same as the last rendered name
+         */
+        const char* Render(std::string_view originalName, std::int32_t progress, std::uint32_t points) {
+            if (progress == lastProgress && points == lastPoints) return nullptr;
+            lastProgress = progress;
+            lastPoints   = points;
+
+            buffer.assign(originalName);
+            if (progress != 0) {
+                char digits[12];
+                auto end = std::to_chars(std::begin(digits), std::end(digits), progress).ptr;
+                buffer.append(" (");
+                buffer.append(digits, end);
+                buffer.append("%)");
+            }
+            buffer.append(points, '*');
+            return buffer.c_str();
+        }
+
+        // Records that the spell is showing its original name, which is what 0% and no points renders as
+        void MarkOriginalName() {
+            lastProgress = 0;
+            lastPoints   = 0;
+        }
+
+        // Whether the spell is showing its original name: never rendered, or rendered at 0% with no points
+        bool ShowsOriginalName() const { return lastProgress <= 0 && lastPoints == 0; }
+
+        // The last rendered progress (-1 if never rendered) and points
+        std::int32_t  LastProgress() const { return lastProgress; }
+        std::uint32_t LastPoints() const { return lastPoints; }
+    };
+}
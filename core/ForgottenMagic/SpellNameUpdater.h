@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Interfaces.h"
+#include "SpellNameRenderer.h"
+#include "XpSnapshot.h"
+
+namespace ForgottenMagic {
+
+    // The registry columns a batch reads and updates, indexed by SpellHandle
+    struct SpellNameColumns {
+        std::span<const SpellIndex>  spellIndexes;
+        std::span<const std::string> originalNames;
+        std::span<SpellNameRenderer> nameRenderers;
+    };
+
+    /**
+     * Turns a batch of spells into renames: snapshots the XP source, computes progress and renders names
+     *
+     * Only spells whose rendered name changed reach the name sink. Only the batch's spell
+     * indexes are copied and computed, into snapshot buffers reused between batches.
+     */
+    class SpellNameUpdater {
+        XpSnapshot              snapshot;
+        std::vector<SpellIndex> batchSpellIndexes;
+
+        // Spells skipped in the last batch because their XP data is unusable, with the reasons
+        std::vector<std::pair<SpellHandle, std::uint8_t>> invalidSpells;
+
+    public:
+        struct Result {
+            bool          captured{false};
+            std::uint64_t renamesIssued{0};
+            std::uint64_t renamesSkipped{0};
+        };
+
+        Result Update(std::span<const SpellHandle> spells, const SpellNameColumns& columns, IXpSource& source, INameSink& sink) {
+            Result result;
+            invalidSpells.clear();
+
+            // Copy just the batch's entries from the source once, and compute their progress in one pass
+            batchSpellIndexes.clear();
+            for (const auto spell : spells) batchSpellIndexes.push_back(columns.spellIndexes[spell]);
+            if (!source.Capture(snapshot, batchSpellIndexes)) return result;
+            snapshot.ComputeProgress(batchSpellIndexes);
+            result.captured = true;
+
+            for (const auto spell : spells) {
+                const auto spellIndex = columns.spellIndexes[spell];
+
+                // Skip just this spell if its entries are missing, mistyped or out of range
+                if (auto invalid = snapshot.Invalid(spellIndex)) {
+                    invalidSpells.emplace_back(spell, invalid);
+                    continue;
+                }
+
+                const auto& originalName = columns.originalNames[spell];
+                if (originalName.empty()) continue;
+
+                // Only rename the spell if its progress or points changed since it was last renamed
+                auto* newName = columns.nameRenderers[spell].Render(originalName, snapshot.Progress(spellIndex), snapshot.Points(spellIndex));
+                if (!newName) {
+                    result.renamesSkipped++;
+                    continue;
+                }
+                sink.SetName(spell, newName);
+                result.renamesIssued++;
+            }
+            return result;
+        }
+
+        // Only the last batch's spell indexes are valid
+        const XpSnapshot& Snapshot() const { return snapshot; }
+
+        const std::vector<std::pair<SpellHandle, std::uint8_t>>& InvalidSpells() const { return invalidSpells; }
+    };
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "EffectFilter.h"
+#include "Interfaces.h"
+#include "SpellNameRenderer.h"
+#include "SpellNameUpdater.h"
+
+namespace ForgottenMagic {
+
+    // Position of a progression source in the host's list of sources
+    using SourceId = std::uint16_t;
+
+    // One configured spell: the book granting a source's spell with the given index
+    struct SpellDefinition {
+        SourceId    source;
+        SpellIndex  spellIndex;
+        std::string bookName;
+    };
+
+    /**
+     * Every configured spell of every progression source, stored as parallel columns ordered by source, then SpellIndex
+     *
+     * A spell's slot (its SpellHandle) is its position in the columns, and is how the rest of
+     * the host refers to spells; the slots of one source are contiguous. Effects are looked up
+     * through an EffectFilter over the tracked effect FormIDs, whose rank indexes an array of
+     * slots, so the event path rejects or resolves an effect in one bitmap probe. Spells are
+     * found by a sorted (spell, slot) vector, and books by a hash index per source which is
+     * only used while loading, so no lookup scans the catalog.
+     *
+     * @tparam Spell The host's spell form (RE::SpellItem in the game)
+     */
+    template <typename Spell>
+    struct SpellRegistry {
+        // Configured from the INI
+        std::vector<SourceId>    sourceIds;
+        std::vector<SpellIndex>  spellIndexes;
+        std::vector<std::string> grantingBookNames;
+
+        // Resolved when the game data is loaded (nullptr / empty for spells whose book was not found)
+        std::vector<Spell*>      spells;
+        std::vector<std::string> originalNames;
+
+        // Last rendered name state of each spell
+        std::vector<SpellNameRenderer> nameRenderers;
+
+    private:
+        // Hashes std::string keys by their contents so books can be found by a std::string_view without allocating
+        struct BookNameHash {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view value) const noexcept { return std::hash<std::string_view>{}(value); }
+        };
+
+        // Copy of each renderer's (progress, points), published by the background thread for the co-save to read on the main thread
+        std::unique_ptr<std::atomic<std::uint64_t>[]> publishedRenderStates;
+
+        std::vector<std::unordered_map<std::string, SpellHandle, BookNameHash, std::equal_to<>>> slotsByBookName;
+        std::vector<std::pair<const Spell*, SpellHandle>>                                       slotsBySpell;
+
+        // Sorted (effect FormID, slot) of every tracked effect, and the same slots indexed by the filter's rank of the FormID
+        std::vector<std::pair<std::uint32_t, SpellHandle>> slotsByEffectFormID;
+        EffectFilter                                       effectFilter;
+        std::vector<SpellHandle>                           slotsByEffectRank;
+
+        template <typename Key>
+        static void SortIndex(std::vector<std::pair<Key, SpellHandle>>& index) {
+            // Keep the first slot seen for each key
+            std::ranges::stable_sort(index, {}, &std::pair<Key, SpellHandle>::first);
+            auto duplicates = std::ranges::unique(index, {}, &std::pair<Key, SpellHandle>::first);
+            index.erase(duplicates.begin(), duplicates.end());
+        }
+
+    public:
+        /**
+         * Lays out one slot per configured spell index of each source, in (source, SpellIndex) order
+         *
+         * @param definitions Every (source, spell index, granting book name) from the INI
+         */
+        void Configure(std::vector<SpellDefinition> definitions) {
+            std::ranges::stable_sort(definitions, {}, [](const SpellDefinition& definition) { return std::pair(definition.source, definition.spellIndex); });
+            for (auto& [source, spellIndex, bookName] : definitions) {
+                // Several books may share a spell index, in which case the last one listed is its granting book
+                if (spellIndexes.empty() || sourceIds.back() != source || spellIndexes.back() != spellIndex) {
+                    sourceIds.push_back(source);
+                    spellIndexes.push_back(spellIndex);
+                    grantingBookNames.emplace_back();
+                }
+                if (slotsByBookName.size() <= source) slotsByBookName.resize(source + 1);
+                slotsByBookName[source].insert_or_assign(bookName, static_cast<SpellHandle>(spellIndexes.size() - 1));
+                grantingBookNames.back() = std::move(bookName);
+            }
+            spells.assign(Size(), nullptr);
+            originalNames.assign(Size(), {});
+            nameRenderers.assign(Size(), {});
+            publishedRenderStates = std::make_unique<std::atomic<std::uint64_t>[]>(Size());
+        }
+
+        /**
+         * Records the spell granted by a slot's book, and indexes its tracked effects
+         *
+         * @param effectFormIDs The spell's effects which should find the slot on the event path
+         */
+        void Bind(SpellHandle slot, Spell* spell, std::string originalName, std::span<const std::uint32_t> effectFormIDs) {
+            spells[slot]        = spell;
+            originalNames[slot] = std::move(originalName);
+            nameRenderers[slot].Reserve(originalNames[slot]);
+            slotsBySpell.emplace_back(spell, slot);
+            for (const auto effectFormID : effectFormIDs) slotsByEffectFormID.emplace_back(effectFormID, slot);
+        }
+
+        // Sorts the side indexes and builds the effect filter once every spell is bound
+        void FinishBinding() {
+            SortIndex(slotsBySpell);
+            SortIndex(slotsByEffectFormID);
+
+            std::vector<std::uint32_t> effectFormIDs;
+            effectFormIDs.reserve(slotsByEffectFormID.size());
+            slotsByEffectRank.clear();
+            slotsByEffectRank.reserve(slotsByEffectFormID.size());
+            for (const auto& [effectFormID, slot] : slotsByEffectFormID) {
+                effectFormIDs.push_back(effectFormID);
+                slotsByEffectRank.push_back(slot);
+            }
+            effectFilter.Build(effectFormIDs);
+        }
+
+        std::size_t Size() const { return spellIndexes.size(); }
+
+        std::optional<SpellHandle> FindByBookName(SourceId source, std::string_view bookName) const {
+            if (source >= slotsByBookName.size()) return std::nullopt;
+            auto found = slotsByBookName[source].find(bookName);
+            if (found == slotsByBookName[source].end()) return std::nullopt;
+            return found->second;
+        }
+        // The contiguous [first, last) slots of a source
+        std::pair<SpellHandle, SpellHandle> SourceSlots(SourceId source) const {
+            const auto first = std::ranges::lower_bound(sourceIds, source);
+            const auto last  = std::ranges::upper_bound(first, sourceIds.end(), source);
+            return {static_cast<SpellHandle>(first - sourceIds.begin()), static_cast<SpellHandle>(last - sourceIds.begin())};
+        }
+
+        std::optional<SpellHandle> FindBySpellIndex(SourceId source, SpellIndex spellIndex) const {
+            // The columns themselves are sorted by (source, spell index)
+            const auto  key = std::pair(source, spellIndex);
+            std::size_t low = 0, high = Size();
+            while (low < high) {
+                const auto middle = low + (high - low) / 2;
+                if (std::pair(sourceIds[middle], spellIndexes[middle]) < key) low = middle + 1;
+                else high = middle;
+            }
+            if (low == Size() || sourceIds[low] != source || spellIndexes[low] != spellIndex) return std::nullopt;
+            return static_cast<SpellHandle>(low);
+        }
+        // Rejects every untracked effect and finds the slot of a tracked one with the same bitmap probe
+        std::optional<SpellHandle> FindByEffectFormID(std::uint32_t effectFormID) const {
+            if (auto rank = effectFilter.Rank(effectFormID)) return slotsByEffectRank[*rank];
+            return std::nullopt;
+        }
+        std::optional<SpellHandle> FindBySpell(const Spell* spell) const {
+            auto found = std::ranges::lower_bound(slotsBySpell, spell, {}, &std::pair<const Spell*, SpellHandle>::first);
+            if (found == slotsBySpell.end() || found->first != spell) return std::nullopt;
+            return found->second;
+        }
+
+        const std::vector<std::pair<std::uint32_t, SpellHandle>>& EffectFormIDs() const { return slotsByEffectFormID; }
+        const EffectFilter&                                       Effects() const { return effectFilter; }
+
+        // Makes a slot's last rendered state visible to PublishedRenderState (background thread, after rendering)
+        void PublishRenderState(SpellHandle slot) {
+            const auto& renderer = nameRenderers[slot];
+            publishedRenderStates[slot].store(std::uint64_t{static_cast<std::uint32_t>(renderer.LastProgress())} << 32 | renderer.LastPoints(), std::memory_order_relaxed);
+        }
+        // The slot's last published (progress, points); (0, 0) if nothing was published (any thread)
+        std::pair<std::int32_t, std::uint32_t> PublishedRenderState(SpellHandle slot) const {
+            const auto state = publishedRenderStates[slot].load(std::memory_order_relaxed);
+            return {static_cast<std::int32_t>(state >> 32), static_cast<std::uint32_t>(state)};
+        }
+
+        // The columns the batch processing reads and updates
+        SpellNameColumns NameColumns() { return {spellIndexes, originalNames, nameRenderers}; }
+    };
+}
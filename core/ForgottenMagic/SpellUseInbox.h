@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "BoundedMpscQueue.h"
+#include "Interfaces.h"
+
+namespace ForgottenMagic {
+
+    /**
+     * Lock-free hand-off of spell casts from any number of event threads to one consumer thread
+     *
+     * Casts are pushed onto a bounded MPSC queue. When it is full, casts are coalesced into a
+     * per-spell atomic slot which keeps the latest cast time, so nothing is lost, only merged.
+     *
+     * The consumer announces when it is about to sleep and until when (BeginSleep), and Record
+     * reports whether that sleep has to be interrupted because the cast could become due
+     * earlier, so producers only need to touch the consumer's mutex and condition variable
+     * when the consumer would otherwise oversleep.
+     */
+    class SpellUseInbox {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // Number of casts which can be in flight between producers and the consumer
+        static constexpr std::size_t CAPACITY = 1024;
+
+        struct SpellUse {
+            SpellHandle       spell{0};
+            Clock::time_point usedAt;
+        };
+
+    private:
+        BoundedMpscQueue<SpellUse, CAPACITY> queue;
+
+        // Latest overflowed cast time of each spell, by handle (0 means none)
+        std::unique_ptr<std::atomic<std::int64_t>[]> overflowLastUseTicks;
+        std::size_t                                  overflowSlotCount{0};
+
+        // Set by producers after writing an overflow slot so the consumer knows to sweep them
+        std::atomic<bool> overflowPending{false};
+
+        // When the consumer's current sleep ends, in clock ticks, or AWAKE
+        static constexpr std::int64_t AWAKE = std::numeric_limits<std::int64_t>::min();
+        std::atomic<std::int64_t>     consumerSleepsUntilTicks{AWAKE};
+
+    public:
+        /**
+         * Allocates one overflow slot per spell
+         *
+         * Must be called before any producer records a cast.
+         */
+        void Resize(std::size_t spellCount) {
+            overflowSlotCount    = spellCount;
+            overflowLastUseTicks = std::make_unique<std::atomic<std::int64_t>[]>(spellCount);
+        }
+
+        /**
+         * Records a cast (producer side, never blocks)
+         *
+         * @param earliestDue The soonest this cast can make its spell due
+         * @return true if the consumer is sleeping past earliestDue and must be woken up
+         */
+        bool Record(SpellHandle spell, Clock::time_point usedAt, Clock::time_point earliestDue) {
+            if (!queue.TryPush({spell, usedAt})) {
+                if (spell >= overflowSlotCount) return false;
+
+                // Keep the latest cast time for this spell
+                auto& lastUseTicks = overflowLastUseTicks[spell];
+                auto  ticks        = usedAt.time_since_epoch().count();
+                auto  seen         = lastUseTicks.load(std::memory_order_relaxed);
+                while (seen < ticks && !lastUseTicks.compare_exchange_weak(seen, ticks, std::memory_order_relaxed)) {
+                }
+                overflowPending.store(true);
+            }
+
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            // Only the producer which swaps the sleep out wakes the consumer
+            auto sleepsUntil = consumerSleepsUntilTicks.load();
+            return sleepsUntil > earliestDue.time_since_epoch().count() && consumerSleepsUntilTicks.compare_exchange_strong(sleepsUntil, AWAKE);
+        }
+
+        /**
+         * Announces that the consumer is about to sleep until the given time (consumer side)
+         *
+         * Pass Clock::time_point::max() to sleep until woken. Call with the consumer's mutex
+         * held, and only sleep if this returns true. Sleep until the given time or until
+         * IsSleeping() is false, then call EndSleep().
+         */
+        bool BeginSleep(Clock::time_point until) {
+            consumerSleepsUntilTicks.store(until.time_since_epoch().count());
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return queue.Empty() && !overflowPending.load();
+        }
+
+        bool IsSleeping() const { return consumerSleepsUntilTicks.load() != AWAKE; }
+
+        void EndSleep() { consumerSleepsUntilTicks.store(AWAKE); }
+
+        /**
+         * Hands every recorded cast to the callback (consumer side)
+         *
+         * @param onSpellUse Called as onSpellUse(SpellHandle, Clock::time_point)
+         */
+        template <typename Callback>
+        void Drain(Callback&& onSpellUse) {
+            SpellUse spellUse;
+            while (queue.TryPop(spellUse)) onSpellUse(spellUse.spell, spellUse.usedAt);
+
+            if (!overflowPending.exchange(false)) return;
+            for (std::size_t i = 0; i < overflowSlotCount; i++) {
+                auto ticks = overflowLastUseTicks[i].exchange(0);
+                if (ticks == 0) continue;
+                onSpellUse(static_cast<SpellHandle>(i), Clock::time_point{Clock::duration{ticks}});
+            }
+        }
+    };
+}
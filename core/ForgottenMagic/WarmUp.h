@@ -0,0 +1,15 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace ForgottenMagic {
+
+    /**
+     * Pacing of the load-time warm-up, which refreshes the player's spells from the XP source
+     * after a game is loaded: how many spells each slice refreshes, and how long the background
+     * thread waits between slices, so that no single frame pays for the whole refresh
+     */
+    constexpr std::size_t WARM_UP_SLICE_SIZE     = 8;
+    constexpr auto        WARM_UP_SLICE_INTERVAL = std::chrono::milliseconds(16);
+}
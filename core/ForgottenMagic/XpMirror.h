@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Interfaces.h"
+#include "XpSnapshot.h"
+
+namespace ForgottenMagic {
+
+    /**
+     * Native copy of a progression source's XP, XP requirement and points, predicted from casts
+     * in between reconciliations with the authoritative arrays
+     *
+     * Each cast adds a fixed amount of XP, capped at the requirement: the mirror never predicts
+     * a level-up, which only shows once a reconciliation brings in the new requirement and
+     * points. Until it is first reconciled the mirror has no data, and Capture reports none.
+     *
+     * The game reports every effect a spell applies, on every target, so RecordEffect counts a
+     * spell's effects as one cast until none has been applied for the cast window. This can
+     * still be wrong either way (two quick casts merged, a long channel counted once), which
+     * reconciliation corrects.
+     *
+     * Not thread-safe: owned by a single consumer thread.
+     */
+    class XpMirror : public IXpSource {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+    private:
+        // Differences below this are rounding, not drift
+        static constexpr float XP_TOLERANCE = 1e-3f;
+
+        std::vector<float>        xp;
+        std::vector<float>        xpReq;
+        std::vector<std::int32_t> points;
+        std::vector<std::uint8_t> invalid;
+        bool                      seeded{false};
+
+        // Latest effect applied by each spell index, and how long after it another effect starts a new cast
+        std::vector<Clock::time_point> lastEffects;
+        Clock::duration                castWindow{};
+
+        std::vector<SpellIndex> drifted;
+
+    public:
+        // Forgets everything, e.g. when another save is loaded; the next Reconcile seeds the mirror without counting drift
+        void Reset() {
+            xp.clear();
+            xpReq.clear();
+            points.clear();
+            invalid.clear();
+            lastEffects.clear();
+            seeded = false;
+        }
+
+        void SetCastWindow(Clock::duration window) { castWindow = window; }
+
+        bool Seeded() const { return seeded; }
+
+        /**
+         * Replaces the mirror with the authoritative values
+         *
+         * @param authoritative A snapshot captured from the source, before ComputeProgress
+         * @return The spell indexes whose predicted values were wrong (none when seeding)
+         */
+        std::span<const SpellIndex> Reconcile(const XpSnapshot& authoritative) {
+            drifted.clear();
+            const auto size = authoritative.Size();
+            for (SpellIndex i = 0; seeded && i < size; i++) {
+                const auto wasInvalid = i < invalid.size() ? invalid[i] : XpSnapshot::OUT_OF_ARRAY_BOUNDS;
+                const auto isInvalid  = authoritative.Invalid(i);
+                if (wasInvalid != isInvalid) {
+                    drifted.push_back(i);
+                    continue;
+                }
+                if (isInvalid) continue;
+                if (std::abs(xp[i] - authoritative.Xp(i)) > XP_TOLERANCE || xpReq[i] != authoritative.XpReq(i) ||
+                    points[i] != static_cast<std::int32_t>(authoritative.Points(i)))
+                    drifted.push_back(i);
+            }
+
+            xp.resize(size);
+            xpReq.resize(size);
+            points.resize(size);
+            invalid.resize(size);
+            lastEffects.resize(size);
+            for (SpellIndex i = 0; i < size; i++) {
+                xp[i]      = authoritative.Xp(i);
+                xpReq[i]   = authoritative.XpReq(i);
+                points[i]  = static_cast<std::int32_t>(authoritative.Points(i));
+                invalid[i] = authoritative.Invalid(i);
+            }
+            seeded = true;
+            return drifted;
+        }
+
+        /**
+         * Predicts the XP a cast earns
+         *
+         * @return Whether the spell's XP changed
+         */
+        bool RecordCast(SpellIndex spellIndex, float xpGain) {
+            if (spellIndex >= xp.size() || invalid[spellIndex]) return false;
+            const auto predicted = std::min(xp[spellIndex] + xpGain, std::max(xp[spellIndex], xpReq[spellIndex]));
+            if (predicted == xp[spellIndex]) return false;
+            xp[spellIndex] = predicted;
+            return true;
+        }
+
+        /**
+         * Predicts the XP of an applied effect, which only earns XP if it starts a new cast
+         *
+         * @return Whether the spell's XP changed
+         */
+        bool RecordEffect(SpellIndex spellIndex, float xpGain, Clock::time_point appliedAt) {
+            if (spellIndex >= lastEffects.size()) return false;
+            auto&      lastEffect = lastEffects[spellIndex];
+            const auto newCast    = lastEffect == Clock::time_point{} || appliedAt - lastEffect >= castWindow;
+            lastEffect            = std::max(lastEffect, appliedAt);
+            return newCast && RecordCast(spellIndex, xpGain);
+        }
+
+        bool Capture(XpSnapshot& snapshot) override {
+            if (!seeded) return false;
+            snapshot.Reset(xp.size());
+            for (SpellIndex i = 0; i < xp.size(); i++) CopyLane(snapshot, i);
+            return true;
+        }
+
+        bool Capture(XpSnapshot& snapshot, std::span<const SpellIndex> spellIndexes) override {
+            if (!seeded) return false;
+            snapshot.Reset(xp.size(), spellIndexes);
+            for (const auto spellIndex : spellIndexes)
+                if (spellIndex < xp.size()) CopyLane(snapshot, spellIndex);
+            return true;
+        }
+
+    private:
+        void CopyLane(XpSnapshot& snapshot, SpellIndex i) const {
+            if (invalid[i] & XpSnapshot::OUT_OF_ARRAY_BOUNDS) return;
+            snapshot.MarkPresent(i);
+            snapshot.SetXp(i, xp[i]);
+            snapshot.SetXpReq(i, xpReq[i]);
+            snapshot.SetPoints(i, points[i]);
+            snapshot.MarkInvalid(i, invalid[i]);
+        }
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Interfaces.h"
+
+namespace ForgottenMagic {
+
+    /**
+     * Contiguous copy of every spell index's XP, XP requirement and available points
+     *
+     * An IXpSource fills the raw columns once per batch (SetXp etc.), then ComputeProgress
+     * works out every spell's progress in a single branch-free pass, so the compiler can
+     * vectorize it. Instead of aborting the batch on the first bad entry, every lane carries
+     * a mask of what is wrong with it.
+     *
+     * A batch of a few spells only resets, fills and computes their lanes (the overloads
+     * taking spell indexes), so its cost does not grow with the size of the arrays.
+     */
+    class XpSnapshot {
+    public:
+        // Reasons a spell index has no usable progress, combined into each lane's invalid mask
+        static constexpr std::uint8_t XP_NOT_FLOAT        = 1 << 0;
+        static constexpr std::uint8_t XP_REQ_NOT_FLOAT    = 1 << 1;
+        static constexpr std::uint8_t POINTS_NOT_INT      = 1 << 2;
+        static constexpr std::uint8_t XP_NEGATIVE         = 1 << 3;
+        static constexpr std::uint8_t XP_REQ_NOT_POSITIVE = 1 << 4;
+        static constexpr std::uint8_t POINTS_NEGATIVE     = 1 << 5;
+        static constexpr std::uint8_t OUT_OF_ARRAY_BOUNDS = 1 << 6;
+
+    private:
+        std::vector<float>        xp;
+        std::vector<float>        xpReq;
+        std::vector<std::int32_t> points;
+        std::vector<std::int32_t> progress;
+        std::vector<std::uint8_t> invalid;
+        std::size_t               size{0};
+
+        void ResetLane(std::size_t i) {
+            xp[i]      = 0.0f;
+            xpReq[i]   = 1.0f;
+            points[i]  = 0;
+            invalid[i] = OUT_OF_ARRAY_BOUNDS;
+        }
+
+        void ComputeLane(std::size_t i) {
+            const auto currentXp = xp[i];
+            const auto required  = xpReq[i];
+            const auto mask      = static_cast<std::uint8_t>(
+                invalid[i] | (currentXp < 0.0f ? XP_NEGATIVE : 0u) | (required <= 0.0f ? XP_REQ_NOT_POSITIVE : 0u) | (points[i] < 0 ? POINTS_NEGATIVE : 0u)
+            );
+            const auto safeRequired = mask ? 1.0f : required;
+            const auto percent      = std::min(std::max(0.0f, (currentXp / safeRequired) * 100.0f), 100.0f);  // Also maps NaN to 0
+            progress[i]             = mask ? 0 : static_cast<std::int32_t>(percent);
+            invalid[i]              = mask;
+        }
+
+    public:
+        /**
+         * Clears the snapshot to hold size spell indexes, every one marked OUT_OF_ARRAY_BOUNDS
+         *
+         * The source then sets the values it has, which clears that flag for them.
+         */
+        void Reset(std::size_t spellIndexCount) {
+            size = spellIndexCount;
+            xp.assign(size, 0.0f);
+            xpReq.assign(size, 1.0f);
+            points.assign(size, 0);
+            progress.resize(size);
+            invalid.assign(size, OUT_OF_ARRAY_BOUNDS);
+        }
+
+        /**
+         * Sizes the snapshot to hold size spell indexes, but only clears the given ones (as Reset does)
+         *
+         * Every other lane keeps whatever it held, so only the given indexes may be read afterwards.
+         */
+        void Reset(std::size_t spellIndexCount, std::span<const SpellIndex> spellIndexes) {
+            size = spellIndexCount;
+            if (xp.size() < size) {
+                xp.resize(size, 0.0f);
+                xpReq.resize(size, 1.0f);
+                points.resize(size, 0);
+                progress.resize(size);
+                invalid.resize(size, OUT_OF_ARRAY_BOUNDS);
+            }
+            for (const auto spellIndex : spellIndexes)
+                if (spellIndex < size) ResetLane(spellIndex);
+        }
+
+        // Copies one spell index's values; a missing or mistyped value is recorded with its flag instead
+        void SetXp(SpellIndex spellIndex, float value) { xp[spellIndex] = value; }
+        void SetXpReq(SpellIndex spellIndex, float value) { xpReq[spellIndex] = value; }
+        void SetPoints(SpellIndex spellIndex, std::int32_t value) { points[spellIndex] = value; }
+        void MarkPresent(SpellIndex spellIndex) { invalid[spellIndex] &= static_cast<std::uint8_t>(~OUT_OF_ARRAY_BOUNDS); }
+        void MarkInvalid(SpellIndex spellIndex, std::uint8_t reasons) { invalid[spellIndex] |= reasons; }
+
+        // Computes progress (0-100) for every spell index in one branch-free pass over every lane
+        void ComputeProgress() {
+            for (std::size_t i = 0; i < size; i++) ComputeLane(i);
+        }
+
+        // Computes progress for just the given spell indexes
+        void ComputeProgress(std::span<const SpellIndex> spellIndexes) {
+            for (const auto spellIndex : spellIndexes)
+                if (spellIndex < size) ComputeLane(spellIndex);
+        }
+
+        std::size_t Size() const { return size; }
+
+        // Reasons the spell index is unusable, or 0 if its progress and points are valid
+        std::uint8_t Invalid(SpellIndex spellIndex) const { return spellIndex < size ? invalid[spellIndex] : OUT_OF_ARRAY_BOUNDS; }
+
+        float         Xp(SpellIndex spellIndex) const { return xp[spellIndex]; }
+        float         XpReq(SpellIndex spellIndex) const { return xpReq[spellIndex]; }
+        std::int32_t  Progress(SpellIndex spellIndex) const { return progress[spellIndex]; }
+        std::uint32_t Points(SpellIndex spellIndex) const { return static_cast<std::uint32_t>(points[spellIndex]); }
+    };
+}
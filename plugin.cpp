@@ -1,404 +1,1650 @@
+#include <ForgottenMagic/AsyncLog.h>
+#include <ForgottenMagic/DebounceScheduler.h>
+#include <ForgottenMagic/EventCapture.h>
+#include <ForgottenMagic/Interfaces.h>
+#include <ForgottenMagic/Metrics.h>
+#include <ForgottenMagic/NameApplyQueue.h>
+#include <ForgottenMagic/RenderedNames.h>
+#include <ForgottenMagic/SpellNameRenderer.h>
+#include <ForgottenMagic/SpellNameUpdater.h>
+#include <ForgottenMagic/SpellRegistry.h>
+#include <ForgottenMagic/SpellUseInbox.h>
+#include <ForgottenMagic/WarmUp.h>
+#include <ForgottenMagic/XpMirror.h>
+#include <ForgottenMagic/XpSnapshot.h>
 #include <SkyrimScripting/Plugin.h>
+#include <ankerl/unordered_dense.h>
 #include <collections.h>
 
 // Do not import SimpleIni until after CommonLib/SkyrimScripting (anything including Windows.h)
 #include <SimpleIni.h>
 
+#ifdef _WIN32
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
 #include <atomic>
+#include <charconv>
 #include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <span>
+#include <string>
 #include <thread>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace std::literals;
-using SpellIndex = std::uint32_t;
+using ForgottenMagic::LogLevel;
+using ForgottenMagic::Metrics;
+using ForgottenMagic::SpellIndex;
+using ForgottenMagic::SpellNameRenderer;
 
-struct SpellInfo {
-    RE::SpellItem* spell{nullptr};
-    SpellIndex     spellIndex{0};
-    std::string    originalSpellName;
-    std::string    grantingBookName;
-};
+// How long a spell must go without being cast before its name is updated, unless [Debounce] says otherwise
+constexpr auto SPELL_QUIET_PERIOD = 1000ms;
+
+// Load-time refresh: how many of the player's spells each slice refreshes, and how long to wait between slices
+using ForgottenMagic::WARM_UP_SLICE_INTERVAL;
+using ForgottenMagic::WARM_UP_SLICE_SIZE;
+
+// When a save's rendered names were restored from the co-save, how long the warm-up waits before reconciling them with the Papyrus arrays
+constexpr auto COSAVE_RECONCILE_DELAY = 10s;
+
+// Time the main thread may spend renaming spells each frame
+constexpr auto RENAME_FRAME_BUDGET = 500us;
 
 constexpr auto INI_FILENAME                   = "Data/SKSE/Plugins/ForgottenMagic_UpdateSpellsWithProgress.ini"sv;
+constexpr auto STARTUP_CACHE_FILENAME         = "Data/SKSE/Plugins/ForgottenMagic_UpdateSpellsWithProgress.cache"sv;
+constexpr auto DEFAULT_PLUGIN_FILENAME        = "ForgottenMagic_Redone.esp"sv;
+constexpr auto LEGACY_SOURCE_NAME             = "ForgottenMagic"sv;
+constexpr auto SOURCE_SECTION_PREFIX          = "Source."sv;
+constexpr auto SPELL_INDEXES_SECTION          = "SpellIndexes"sv;
+constexpr auto SPELL_INDEXES_SECTION_SUFFIX   = ".SpellIndexes"sv;
 constexpr auto MCM_QUEST_EDITOR_ID            = "vMCM"sv;
 constexpr auto MCM_SCRIPT                     = "vMCMscript"sv;
 constexpr auto PAPYRUS_XP_TRACKER_ARRAY       = "fSPXP"sv;
 constexpr auto PAPYRUS_XP_REQUIREMENT_ARRAY   = "fXPreq"sv;
 constexpr auto PAPYRUS_POINTS_AVAILABLE_ARRAY = "iPoints"sv;
 
-std::string        forgottenMagicFilename = "ForgottenMagic_Redone.esp";
-const RE::TESFile* forgottenMagicFile     = nullptr;
-const RE::TESForm* mcmQuest               = nullptr;
+// Script declaring the native functions a progression mod's MCM script calls to report XP changes
+constexpr auto PAPYRUS_API_SCRIPT = "ForgottenMagic_UpdateSpellsWithProgress"sv;
+
+constexpr auto DEFAULT_METRICS_FILENAME        = "Data/SKSE/Plugins/ForgottenMagic_UpdateSpellsWithProgress.metrics.json"sv;
+constexpr auto DEFAULT_CAPTURE_FILENAME        = "Data/SKSE/Plugins/ForgottenMagic_UpdateSpellsWithProgress.capture"sv;
+
+// Formats and writes log messages on its own thread; see LogTrace ... LogError
+// String arguments are copied into the message's record and cut to their first 63 characters, so longer
+// spell names, book names and file paths (such as the default capture and metrics files) are logged truncated
+ForgottenMagic::AsyncLog asyncLog;
+
+template <typename... Args>
+void LogTrace(ForgottenMagic::LogFormat<Args...> format, Args&&... args) {
+    asyncLog.Write<LogLevel::Trace>(format, std::forward<Args>(args)...);
+}
+template <typename... Args>
+void LogDebug(ForgottenMagic::LogFormat<Args...> format, Args&&... args) {
+    asyncLog.Write<LogLevel::Debug>(format, std::forward<Args>(args)...);
+}
+template <typename... Args>
+void LogInfo(ForgottenMagic::LogFormat<Args...> format, Args&&... args) {
+    asyncLog.Write<LogLevel::Info>(format, std::forward<Args>(args)...);
+}
+template <typename... Args>
+void LogWarn(ForgottenMagic::LogFormat<Args...> format, Args&&... args) {
+    asyncLog.Write<LogLevel::Warn>(format, std::forward<Args>(args)...);
+}
+template <typename... Args>
+void LogError(ForgottenMagic::LogFormat<Args...> format, Args&&... args) {
+    asyncLog.Write<LogLevel::Error>(format, std::forward<Args>(args)...);
+}
+
+// Called on the log writer thread with each formatted message
+void WriteLogLine(LogLevel level, std::string_view line) {
+    switch (level) {
+        case LogLevel::Trace:
+            SKSE::log::trace("{}", line);
+            break;
+        case LogLevel::Debug:
+            SKSE::log::debug("{}", line);
+            break;
+        case LogLevel::Info:
+            SKSE::log::info("{}", line);
+            break;
+        case LogLevel::Warn:
+            SKSE::log::warn("{}", line);
+            break;
+        default:
+            SKSE::log::error("{}", line);
+            break;
+    }
+}
+
+// Hashes std::string keys by their contents so maps can be searched with a std::string_view without allocating
+struct TransparentStringHash {
+    using is_transparent = void;
+    using is_avalanching = void;
+
+    std::uint64_t operator()(std::string_view value) const noexcept { return ankerl::unordered_dense::hash<std::string_view>{}(value); }
+};
+
+/**
+ * Every INI value outside [SpellIndexes], keyed by "Section.key"
+ *
+ * Kept apart from CSimpleIniA so that settings can be restored from the startup cache
+ * without parsing the INI.
+ */
+class IniSettings {
+    ankerl::unordered_dense::map<std::string, std::string, TransparentStringHash, std::equal_to<>> values;
+
+    const std::string* Find(std::string_view section, std::string_view key) const {
+        std::string qualifiedKey;
+        qualifiedKey.reserve(section.size() + 1 + key.size());
+        qualifiedKey.append(section).append(".").append(key);
+        auto found = values.find(qualifiedKey);
+        return found == values.end() ? nullptr : &found->second;
+    }
+
+public:
+    void Set(std::string qualifiedKey, std::string value) { values.insert_or_assign(std::move(qualifiedKey), std::move(value)); }
+    void Set(std::string_view section, std::string_view key, std::string value) { Set(std::string(section) + "." + std::string(key), std::move(value)); }
+
+    void Clear() { values.clear(); }
+
+    const auto& All() const { return values; }
+
+    std::string GetString(std::string_view section, std::string_view key, std::string_view defaultValue) const {
+        const auto* value = Find(section, key);
+        return value ? *value : std::string(defaultValue);
+    }
+
+    long GetLong(std::string_view section, std::string_view key, long defaultValue) const {
+        const auto* value = Find(section, key);
+        if (!value) return defaultValue;
+        long result;
+        auto [end, error] = std::from_chars(value->data(), value->data() + value->size(), result);
+        return error == std::errc{} ? result : defaultValue;
+    }
+
+    double GetDouble(std::string_view section, std::string_view key, double defaultValue) const {
+        const auto* value = Find(section, key);
+        if (!value) return defaultValue;
+        double result;
+        auto [end, error] = std::from_chars(value->data(), value->data() + value->size(), result);
+        return error == std::errc{} ? result : defaultValue;
+    }
+
+    bool GetBool(std::string_view section, std::string_view key, bool defaultValue) const {
+        const auto* value = Find(section, key);
+        if (!value || value->empty()) return defaultValue;
+        switch ((*value)[0]) {
+            case '1':
+            case 't':
+            case 'T':
+            case 'y':
+            case 'Y':
+                return true;
+            case 'o':
+            case 'O':
+                return value->size() > 1 && ((*value)[1] == 'n' || (*value)[1] == 'N');
+            default:
+                return false;
+        }
+    }
+};
+
+IniSettings iniSettings;
+
+// Position of a progression source in progressionSources
+using ForgottenMagic::SourceId;
+
+/**
+ * A spell progression mod: the plugin whose books grant its spells, and the quest script
+ * holding its XP, XP requirement and points arrays, indexed by each spell's SpellIndex
+ *
+ * Each [Source.<name>] section describes one source, with its spell indexes in
+ * [Source.<name>.SpellIndexes]. Without any, [ForgottenMagic] and [SpellIndexes] describe
+ * the single legacy source.
+ */
+struct ProgressionSource {
+    std::string name;
+    std::string pluginFilename;
+    std::string questEditorID;
+    std::string xpProperty;
+    std::string xpRequirementProperty;
+    std::string pointsProperty;
+    bool        legacy{false};
+
+    // Resolved when the game data is loaded (nullptr if the plugin or quest was not found)
+    const RE::TESFile* file{nullptr};
+    const RE::TESForm* quest{nullptr};
+
+    std::string SpellIndexesSection() const { return legacy ? std::string(SPELL_INDEXES_SECTION) : std::string(SOURCE_SECTION_PREFIX) + name + std::string(SPELL_INDEXES_SECTION_SUFFIX); }
+};
+
+// Ordered by name, so that SourceIds are stable for the same INI
+std::vector<ProgressionSource> progressionSources;
+
+// Reads every [Source.<name>] section, or the legacy [ForgottenMagic] section if there are none
+std::vector<ProgressionSource> ReadProgressionSources(const IniSettings& settings) {
+    std::vector<std::string> names;
+    for (const auto& [qualifiedKey, value] : settings.All()) {
+        std::string_view key = qualifiedKey;
+        if (!key.starts_with(SOURCE_SECTION_PREFIX)) continue;
+        key.remove_prefix(SOURCE_SECTION_PREFIX.size());
+        const auto separator = key.rfind('.');
+        if (separator != std::string_view::npos && separator > 0) names.emplace_back(key.substr(0, separator));
+    }
+    std::ranges::sort(names);
+    names.erase(std::ranges::unique(names).begin(), names.end());
+
+    auto read = [&](std::string_view section, std::string_view name, bool legacy) {
+        return ProgressionSource{std::string(name),
+                                 settings.GetString(section, "plugin_filename", DEFAULT_PLUGIN_FILENAME),
+                                 settings.GetString(section, "quest_editor_id", MCM_QUEST_EDITOR_ID),
+                                 settings.GetString(section, "xp_property", PAPYRUS_XP_TRACKER_ARRAY),
+                                 settings.GetString(section, "xp_requirement_property", PAPYRUS_XP_REQUIREMENT_ARRAY),
+                                 settings.GetString(section, "points_property", PAPYRUS_POINTS_AVAILABLE_ARRAY),
+                                 legacy};
+    };
+
+    std::vector<ProgressionSource> sources;
+    if (names.empty()) sources.push_back(read("ForgottenMagic", LEGACY_SOURCE_NAME, true));
+    for (const auto& name : names) sources.push_back(read(std::string(SOURCE_SECTION_PREFIX) + name, name, false));
+    return sources;
+}
+
+// Sources are few, so they are simply searched in order
+std::optional<SourceId> FindProgressionSource(std::string_view name) {
+    for (SourceId source = 0; source < progressionSources.size(); source++)
+        if (progressionSources[source].name == name) return source;
+    return std::nullopt;
+}
+
+std::optional<SourceId> FindProgressionSourceOfForm(RE::FormID formID) {
+    for (SourceId source = 0; source < progressionSources.size(); source++)
+        if (progressionSources[source].file && progressionSources[source].file->IsFormInMod(formID)) return source;
+    return std::nullopt;
+}
+
+// Position of a spell in the SpellRegistry columns, which is also its handle in the core library
+using SpellSlot = ForgottenMagic::SpellHandle;
 
-collections_map<SpellIndex, SpellInfo>      spellInfosByIndex;
-collections_map<RE::FormID, RE::SpellItem*> spellEffectsBySpellEffectFormID;
-collections_map<RE::SpellItem*, SpellInfo>  spellInfosBySpellItem;
+using ForgottenMagic::SpellDefinition;
+
+// Every configured spell of every progression source; see ForgottenMagic::SpellRegistry
+ForgottenMagic::SpellRegistry<RE::SpellItem> spellRegistry;
+
+// Event rates, cast-to-rename latencies and rename counts, configured from the INI's [Metrics] section
+Metrics metrics;
+
+// Whether casts still trigger updates once the MCM script reports XP changes through the Papyrus API ([PapyrusApi] cast_events)
+enum class CastEvents : std::uint8_t { On, Off, Auto };
+CastEvents        castEvents = CastEvents::Auto;
+std::atomic<bool> papyrusApiUsed{false};
+
+bool CastEventsEnabled() { return castEvents == CastEvents::On || (castEvents == CastEvents::Auto && !papyrusApiUsed.load(std::memory_order_relaxed)); }
+
+// How many times a batch has renamed a spell, and how many times it skipped one because its name would not change
+std::atomic<std::uint64_t> spellRenamesIssued{0};
+std::atomic<std::uint64_t> spellRenamesSkipped{0};
+
+/**
+ * Records the spell granted by a slot's book
+ *
+ * Only the spell's effects from its source's own plugin are tracked, so effects shared with
+ * other spells (such as the base game's) never reach the event path.
+ */
+void BindSpell(SpellSlot slot, RE::SpellItem* spell) {
+    std::vector<std::uint32_t> effectFormIDs;
+    const auto*                sourceFile = progressionSources[spellRegistry.sourceIds[slot]].file;
+    for (auto& effect : spell->effects)
+        if (sourceFile->IsFormInMod(effect->baseEffect->GetFormID())) effectFormIDs.push_back(effect->baseEffect->GetFormID());
+    spellRegistry.Bind(slot, spell, spell->GetName(), effectFormIDs);
+}
+
+// Builds the registry's side indexes and effect filter once every spell is bound
+void FinishBindingSpells() {
+    spellRegistry.FinishBinding();
+    LogInfo("Built effect filter for {} spell effects over {} FormIDs", spellRegistry.EffectFormIDs().size(), spellRegistry.Effects().Range());
+}
+
+/**
+ * Read-only memory mapping of a whole file
+ *
+ * Bytes() is empty if the file does not exist, is empty, or could not be mapped.
+ */
+class MappedFile {
+#ifdef _WIN32
+    HANDLE file{INVALID_HANDLE_VALUE};
+    HANDLE mapping{nullptr};
+#endif
+    const std::byte* data{nullptr};
+    std::size_t      size{0};
+
+public:
+    explicit MappedFile(const char* path) {
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return;
+        data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data) size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        auto descriptor = open(path, O_RDONLY);
+        if (descriptor < 0) return;
+        struct stat fileStat;
+        if (fstat(descriptor, &fileStat) == 0 && fileStat.st_size > 0) {
+            auto* view = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (view != MAP_FAILED) {
+                data = static_cast<const std::byte*>(view);
+                size = static_cast<std::size_t>(fileStat.st_size);
+            }
+        }
+        close(descriptor);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data) munmap(const_cast<std::byte*>(data), size);
+#endif
+    }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::span<const std::byte> Bytes() const { return {data, size}; }
+};
+
+/**
+ * Appends ForgottenMagic::EventCapture records to a preallocated, memory-mapped capture file
+ *
+ * Append is lock-free and safe from any thread: it claims a record with one atomic increment
+ * and writes it straight into the mapping. Events past the file's capacity are dropped.
+ * Close only writes the record count and flushes, leaving the mapping in place, so an
+ * Append racing with shutdown never writes to unmapped memory.
+ */
+class EventCaptureWriter {
+    using Header = ForgottenMagic::EventCapture::Header;
+    using Effect = ForgottenMagic::EventCapture::Effect;
+    using Record = ForgottenMagic::EventCapture::Record;
+
+#ifdef _WIN32
+    HANDLE file{INVALID_HANDLE_VALUE};
+    HANDLE mapping{nullptr};
+#else
+    int descriptor{-1};
+#endif
+    std::byte*  data{nullptr};
+    std::size_t size{0};
+
+    Record*                               records{nullptr};
+    std::uint64_t                         capacity{0};
+    std::atomic<std::uint64_t>            nextRecord{0};
+    std::chrono::steady_clock::time_point openedAt;
+    std::atomic<bool>                     open{false};
+
+    bool Map(const char* path) {
+#ifdef _WIN32
+        file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        const auto size64 = static_cast<std::uint64_t>(size);
+        mapping           = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), nullptr);
+        if (!mapping) return false;
+        data = static_cast<std::byte*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size));
+#else
+        descriptor = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (descriptor < 0 || ftruncate(descriptor, static_cast<off_t>(size)) != 0) return false;
+        auto* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        if (view != MAP_FAILED) data = static_cast<std::byte*>(view);
+#endif
+        return data != nullptr;
+    }
+
+public:
+    ~EventCaptureWriter() { Close(); }
+
+    /**
+     * Creates the capture file with room for recordCapacity events
+     *
+     * @param effects Every tracked effect and the spell slot it belongs to
+     */
+    bool Open(const std::string& path, std::uint64_t recordCapacity, std::span<const Effect> effects) {
+        if (open) return true;
+        size = ForgottenMagic::EventCapture::RecordsOffset(effects.size()) + recordCapacity * sizeof(Record);
+        if (!Map(path.c_str())) return false;
+
+        Header header{ForgottenMagic::EventCapture::MAGIC, ForgottenMagic::EventCapture::VERSION, static_cast<std::uint32_t>(effects.size()), 0, recordCapacity, 0};
+        std::memcpy(data, &header, sizeof(header));
+        std::memcpy(data + sizeof(header), effects.data(), effects.size_bytes());
+
+        records  = reinterpret_cast<Record*>(data + ForgottenMagic::EventCapture::RecordsOffset(effects.size()));
+        capacity = recordCapacity;
+        openedAt = std::chrono::steady_clock::now();
+        open     = true;
+        return true;
+    }
+
+    bool IsOpen() const { return open.load(std::memory_order_relaxed); }
+
+    void Append(RE::FormID effectFormID, RE::FormID casterFormID, RE::FormID targetFormID) {
+        const auto index = nextRecord.fetch_add(1, std::memory_order_relaxed);
+        if (index >= capacity) return;
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - openedAt).count();
+        records[index]     = {static_cast<std::uint64_t>(elapsed), effectFormID, casterFormID, targetFormID, 0};
+    }
+
+    // Writes the record count and flushes the file; later events are no longer recorded
+    void Close() {
+        if (!open.exchange(false)) return;
+        const auto recordCount = std::min(nextRecord.load(), capacity);
+        std::memcpy(data + offsetof(Header, recordCount), &recordCount, sizeof(recordCount));
+#ifdef _WIN32
+        FlushViewOfFile(data, size);
+#else
+        msync(data, size, MS_SYNC);
+#endif
+        LogInfo("[Capture] Captured {} events ({} dropped)", recordCount, nextRecord.load() - recordCount);
+    }
+};
+
+EventCaptureWriter eventCapture;
+
+// 64-bit FNV-1a
+std::uint64_t HashBytes(std::span<const std::byte> bytes) {
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (auto byte : bytes) {
+        hash ^= static_cast<std::uint8_t>(byte);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * Startup cache of the parsed INI and the spells resolved from the progression sources' plugins
+ *
+ * Written next to the INI after a full startup, and used on the next launch instead of
+ * parsing the INI and scanning every book, as long as the INI contents and every source's
+ * plugin file are unchanged. Spells are stored by local FormID so that a change in load
+ * order position does not invalidate the cache. The sources themselves are read back from
+ * the cached settings.
+ *
+ * Layout (native endianness):
+ *   Header
+ *   PluginFile[header.sourceCount], in SourceId order
+ *   Entry[header.spellCount]
+ *   Book names (each entry's bookNameLength bytes, in entry order)
+ *   Setting[header.settingCount], each followed by its key and value bytes
+ */
+namespace StartupCache {
+    constexpr std::uint32_t MAGIC   = 0x4355'4D46;  // "FMUC"
+    constexpr std::uint32_t VERSION = 4;
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t iniHash;
+        std::uint32_t sourceCount;
+        std::uint32_t spellCount;
+        std::uint32_t settingCount;
+        std::uint32_t reserved;
+    };
+
+    struct PluginFile {
+        std::uint64_t size;
+        std::int64_t  time;
+    };
+
+    // Followed, after every entry, by each entry's book name and then the filename of the plugin defining its spell
+    struct Entry {
+        std::uint32_t source;
+        SpellIndex    spellIndex;
+        RE::FormID    spellLocalFormID;  // 0 if the spell's book was not found
+        std::uint32_t bookNameLength;
+        std::uint32_t spellFilenameLength;
+    };
+
+    struct Setting {
+        std::uint32_t keyLength;
+        std::uint32_t valueLength;
+    };
+
+    // Hash of the INI file read at startup
+    std::uint64_t iniHash = 0;
+
+    // Local FormIDs of each registry slot's spell, and the plugin defining it, restored from the cache (empty on a miss)
+    // A book may teach a spell from another plugin, such as a master, so the spell is not looked up in the source's plugin
+    std::vector<RE::FormID>  spellLocalFormIDs;
+    std::vector<std::string> spellFilenames;
+
+    bool hit = false;
+
+    // Identifies the current version of the plugin file on disk
+    bool StatPluginFile(const std::string& pluginFilename, std::uint64_t& size, std::int64_t& time) {
+        std::error_code error;
+        const auto      path = std::filesystem::path("Data") / pluginFilename;
+        size                 = std::filesystem::file_size(path, error);
+        if (error) return false;
+        time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        return !error;
+    }
+
+    // Bounds-checked sequential reads out of the mapped cache file
+    struct Reader {
+        std::span<const std::byte> bytes;
+        std::size_t                offset{0};
+
+        template <typename T>
+        bool Read(T& value) {
+            if (bytes.size() - offset < sizeof(T)) return false;
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            offset += sizeof(T);
+            return true;
+        }
+
+        // Whether count values of the given size remain, checked before sizing anything from a count in the file
+        bool Holds(std::size_t count, std::size_t size) const { return count <= (bytes.size() - offset) / size; }
+
+        bool ReadString(std::string& value, std::size_t length) {
+            if (bytes.size() - offset < length) return false;
+            value.assign(reinterpret_cast<const char*>(bytes.data() + offset), length);
+            offset += length;
+            return true;
+        }
+    };
+
+    /**
+     * Restores the sources, spell table and settings if the cache matches the INI and every source's plugin file
+     *
+     * @return Whether the cache was used, in which case the INI does not need to be parsed
+     */
+    bool Load() {
+        MappedFile cacheFile(STARTUP_CACHE_FILENAME.data());
+        Reader     reader{cacheFile.Bytes()};
+
+        Header header;
+        if (!reader.Read(header) || header.magic != MAGIC || header.version != VERSION || header.iniHash != iniHash) return false;
+
+        if (!reader.Holds(header.sourceCount, sizeof(PluginFile))) return false;
+        std::vector<PluginFile> pluginFiles(header.sourceCount);
+        for (auto& pluginFile : pluginFiles)
+            if (!reader.Read(pluginFile)) return false;
+
+        if (!reader.Holds(header.spellCount, sizeof(Entry))) return false;
+        std::vector<Entry> entries(header.spellCount);
+        for (auto& entry : entries)
+            if (!reader.Read(entry) || entry.source >= header.sourceCount) return false;
+
+        std::vector<SpellDefinition> definitions;
+        std::vector<std::string>     filenames;
+        definitions.reserve(entries.size());
+        filenames.reserve(entries.size());
+        for (const auto& entry : entries) {
+            std::string bookName, spellFilename;
+            if (!reader.ReadString(bookName, entry.bookNameLength) || !reader.ReadString(spellFilename, entry.spellFilenameLength)) return false;
+            definitions.push_back({static_cast<SourceId>(entry.source), entry.spellIndex, std::move(bookName)});
+            filenames.push_back(std::move(spellFilename));
+        }
+
+        IniSettings settings;
+        for (std::uint32_t i = 0; i < header.settingCount; i++) {
+            Setting     setting;
+            std::string key, value;
+            if (!reader.Read(setting) || !reader.ReadString(key, setting.keyLength) || !reader.ReadString(value, setting.valueLength)) return false;
+            settings.Set(std::move(key), std::move(value));
+        }
+
+        auto sources = ReadProgressionSources(settings);
+        if (sources.size() != pluginFiles.size()) return false;
+        for (SourceId source = 0; source < sources.size(); source++) {
+            PluginFile current;
+            if (!StatPluginFile(sources[source].pluginFilename, current.size, current.time)) return false;
+            if (current.size != pluginFiles[source].size || current.time != pluginFiles[source].time) return false;
+        }
+
+        iniSettings        = std::move(settings);
+        progressionSources = std::move(sources);
+        spellRegistry.Configure(std::move(definitions));
+        spellLocalFormIDs.clear();
+        for (const auto& entry : entries) spellLocalFormIDs.push_back(entry.spellLocalFormID);
+        spellFilenames = std::move(filenames);
+        hit = spellLocalFormIDs.size() == spellRegistry.Size();
+        return hit;
+    }
+
+    /**
+     * Binds every cached spell without scanning the books
+     *
+     * @return false if any cached spell no longer resolves, in which case nothing was bound
+     */
+    bool RestoreSpells() {
+        if (!hit) return false;
+
+        auto*                       dataHandler = RE::TESDataHandler::GetSingleton();
+        std::vector<RE::SpellItem*> spells(spellLocalFormIDs.size(), nullptr);
+        for (SpellSlot slot = 0; slot < spells.size(); slot++) {
+            // Spells of sources whose plugin is not loaded stay unbound
+            const auto& source = progressionSources[spellRegistry.sourceIds[slot]];
+            if (!spellLocalFormIDs[slot] || !source.file) continue;
+            spells[slot] = dataHandler->LookupForm<RE::SpellItem>(spellLocalFormIDs[slot], spellFilenames[slot]);
+            if (!spells[slot]) {
+                LogWarn("[Cache] Cached spell {:#x} in {} for spell index {} no longer exists", spellLocalFormIDs[slot], spellFilenames[slot], spellRegistry.spellIndexes[slot]);
+                hit = false;
+                return false;
+            }
+        }
+
+        auto found = 0;
+        for (SpellSlot slot = 0; slot < spells.size(); slot++) {
+            if (!spells[slot]) continue;
+            BindSpell(slot, spells[slot]);
+            found++;
+        }
+        FinishBindingSpells();
+        LogInfo("[Cache] Restored {} out of {} tracked spells from the startup cache", found, spellRegistry.Size());
+        return true;
+    }
+
+    // Writes the cache for the current INI, plugin files and resolved spells
+    void Save() {
+        Header header{MAGIC,
+                      VERSION,
+                      iniHash,
+                      static_cast<std::uint32_t>(progressionSources.size()),
+                      static_cast<std::uint32_t>(spellRegistry.Size()),
+                      static_cast<std::uint32_t>(iniSettings.All().size()),
+                      0};
+        std::vector<PluginFile> pluginFiles(progressionSources.size());
+        for (SourceId source = 0; source < progressionSources.size(); source++)
+            if (!StatPluginFile(progressionSources[source].pluginFilename, pluginFiles[source].size, pluginFiles[source].time)) return;
+
+        // The plugin defining each spell, which need not be its book's plugin; a spell without one cannot be found again by local FormID
+        std::vector<std::string_view> spellFilenames(spellRegistry.Size());
+        for (SpellSlot slot = 0; slot < spellRegistry.Size(); slot++) {
+            const auto* spell = spellRegistry.spells[slot];
+            if (!spell) continue;
+            const auto* file = spell->GetFile(0);
+            if (!file) {
+                LogWarn("[Cache] Not writing startup cache: spell {:#x} is not defined by a plugin", spell->GetFormID());
+                return;
+            }
+            spellFilenames[slot] = file->GetFilename();
+        }
+
+        // Write to a temporary file and move it into place so a crash never leaves a half-written cache
+        const auto temporaryFilename = std::string(STARTUP_CACHE_FILENAME) + ".tmp";
+        {
+            std::ofstream cacheFile(temporaryFilename, std::ios::binary | std::ios::trunc);
+            if (!cacheFile) return;
+            cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            cacheFile.write(reinterpret_cast<const char*>(pluginFiles.data()), static_cast<std::streamsize>(pluginFiles.size() * sizeof(PluginFile)));
+            for (SpellSlot slot = 0; slot < spellRegistry.Size(); slot++) {
+                const auto* spell = spellRegistry.spells[slot];
+                Entry       entry{spellRegistry.sourceIds[slot], spellRegistry.spellIndexes[slot], spell ? spell->GetLocalFormID() : 0,
+                            static_cast<std::uint32_t>(spellRegistry.grantingBookNames[slot].size()), static_cast<std::uint32_t>(spellFilenames[slot].size())};
+                cacheFile.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+            }
+            for (SpellSlot slot = 0; slot < spellRegistry.Size(); slot++) {
+                cacheFile.write(spellRegistry.grantingBookNames[slot].data(), spellRegistry.grantingBookNames[slot].size());
+                cacheFile.write(spellFilenames[slot].data(), spellFilenames[slot].size());
+            }
+            for (const auto& [key, value] : iniSettings.All()) {
+                Setting setting{static_cast<std::uint32_t>(key.size()), static_cast<std::uint32_t>(value.size())};
+                cacheFile.write(reinterpret_cast<const char*>(&setting), sizeof(setting));
+                cacheFile.write(key.data(), key.size());
+                cacheFile.write(value.data(), value.size());
+            }
+            if (!cacheFile) return;
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryFilename, STARTUP_CACHE_FILENAME, error);
+        if (error) LogWarn("[Cache] Could not write startup cache: {}", error.message());
+        else LogInfo("[Cache] Wrote startup cache for {} spells", spellRegistry.Size());
+    }
+}
+
+// Applies [Logging] level (trace, debug, info, warn, error or off)
+void ConfigureLogging() {
+    const auto levelName = iniSettings.GetString("Logging", "level", "info");
+    if (auto level = ForgottenMagic::ParseLogLevel(levelName)) asyncLog.SetLevel(*level);
+    else LogWarn("[INI] Unknown log level '{}', using info", levelName);
+}
 
 void ParseIni() {
+    MappedFile iniFile(INI_FILENAME.data());
+    StartupCache::iniHash = HashBytes(iniFile.Bytes());
+    if (StartupCache::Load()) {
+        ConfigureLogging();
+        LogInfo("[INI] Loaded {} spell indexes for {} progression sources from the startup cache", spellRegistry.Size(), progressionSources.size());
+        return;
+    }
+
     CSimpleIniA ini;
     ini.SetUnicode();
 
-    if (ini.LoadFile(INI_FILENAME.data()) == SI_OK) {
-        forgottenMagicFilename = ini.GetValue("ForgottenMagic", "plugin_filename", forgottenMagicFilename.c_str());
-        Log("[INI] Forgotten Magic plugin filename: {}", forgottenMagicFilename);
+    std::vector<SpellDefinition> definitions;
+    const auto                   iniContents = iniFile.Bytes();
+    if (!iniContents.empty() && ini.LoadData(reinterpret_cast<const char*>(iniContents.data()), iniContents.size()) == SI_OK) {
+        CSimpleIniA::TNamesDepend sections;
+        ini.GetAllSections(sections);
+        for (const auto& section : sections) {
+            // Spell index maps are read per source below
+            const std::string_view sectionName = section.pItem;
+            if (sectionName == SPELL_INDEXES_SECTION || sectionName.ends_with(SPELL_INDEXES_SECTION_SUFFIX)) continue;
+            CSimpleIniA::TNamesDepend keys;
+            ini.GetAllKeys(section.pItem, keys);
+            for (const auto& key : keys) iniSettings.Set(section.pItem, key.pItem, ini.GetValue(section.pItem, key.pItem, ""));
+        }
+        ConfigureLogging();
+    }
+
+    progressionSources = ReadProgressionSources(iniSettings);
+    for (SourceId source = 0; source < progressionSources.size(); source++) {
+        const auto& progressionSource = progressionSources[source];
+        LogInfo("[INI] Progression source '{}': plugin {}, quest {}", progressionSource.name, progressionSource.pluginFilename, progressionSource.questEditorID);
 
+        const auto                spellIndexesSection = progressionSource.SpellIndexesSection();
         CSimpleIniA::TNamesDepend spellIndexBookNameKeys;
-        if (ini.GetAllKeys("SpellIndexes", spellIndexBookNameKeys)) {
-            for (auto& sectionEntry : spellIndexBookNameKeys) {
-                const auto* bookName       = sectionEntry.pItem;
-                const auto  spellIndex     = ini.GetLongValue("SpellIndexes", bookName, 0);
-                auto&       spellInfo      = spellInfosByIndex.emplace(spellIndex, SpellInfo{}).first->second;
-                spellInfo.grantingBookName = bookName;
-                spellInfo.spellIndex       = spellIndex;
-                Log("[INI] Spell Book '{}' has spell index {}", bookName, spellIndex);
-            }
+        if (!ini.GetAllKeys(spellIndexesSection.c_str(), spellIndexBookNameKeys)) continue;
+        for (auto& sectionEntry : spellIndexBookNameKeys) {
+            const auto* bookName   = sectionEntry.pItem;
+            const auto  spellIndex = static_cast<SpellIndex>(ini.GetLongValue(spellIndexesSection.c_str(), bookName, 0));
+            definitions.push_back({source, spellIndex, bookName});
+            LogDebug("[INI] Spell Book '{}' has spell index {}", bookName, spellIndex);  // Book names over 63 characters are logged truncated
         }
     }
+    spellRegistry.Configure(std::move(definitions));
 }
 
-bool LookupForgottenMagicPluginAndMCM() {
-    forgottenMagicFile = RE::TESDataHandler::GetSingleton()->LookupModByName(forgottenMagicFilename);
-    if (forgottenMagicFile) {
-        Log("Found Forgotten Magic plugin: {}", forgottenMagicFile->GetFilename());
-        mcmQuest = RE::TESForm::LookupByEditorID(MCM_QUEST_EDITOR_ID);
-        if (mcmQuest) {
-            Log("Found MCM quest: {}", mcmQuest->GetName());
-            return true;
-        } else {
-            SKSE::log::error("Could not find MCM quest with editor ID {}", MCM_QUEST_EDITOR_ID);
-            return false;
+/**
+ * Finds each source's plugin and MCM quest; a source missing either is left without a file and its spells stay unbound
+ *
+ * @return Whether at least one source was found
+ */
+bool LookupProgressionSources() {
+    auto found = 0;
+    for (auto& source : progressionSources) {
+        source.file = RE::TESDataHandler::GetSingleton()->LookupModByName(source.pluginFilename);
+        if (!source.file) {
+            LogError("[{}] Could not find {}", source.name, source.pluginFilename);
+            continue;
         }
-    } else {
-        SKSE::log::error("Could not find {}", forgottenMagicFilename);
-        return false;
+        source.quest = RE::TESForm::LookupByEditorID(source.questEditorID);
+        if (!source.quest) {
+            LogError("[{}] Could not find MCM quest with editor ID {}", source.name, source.questEditorID);
+            source.file = nullptr;
+            continue;
+        }
+        LogInfo("[{}] Found plugin {} and MCM quest {}", source.name, source.file->GetFilename(), source.quest->GetName());
+        found++;
     }
+    return found > 0;
 }
 
 void LoadForgottenMagicSpellsData() {
-    auto found                 = 0;
-    auto allBooksInTheGameData = RE::TESDataHandler::GetSingleton()->GetFormArray<RE::TESObjectBOOK>();
+    auto  found                 = 0;
+    auto& allBooksInTheGameData = RE::TESDataHandler::GetSingleton()->GetFormArray<RE::TESObjectBOOK>();
     for (const auto& book : allBooksInTheGameData) {
-        if (forgottenMagicFile->IsFormInMod(book->GetFormID())) {
-            if (book->TeachesSpell()) {
-                auto* spell = book->GetSpell();
-                Log("Found Forgotten Magic spell book '{}' grants spell '{}'", book->GetName(), spell->GetName());
-                for (auto& [spellIndex, spellInfo] : spellInfosByIndex) {
-                    if (book->fullName == spellInfo.grantingBookName.c_str()) {
-                        Log("Matched this spell book with spell index {}", spellIndex);
-                        spellInfo.spell             = spell;
-                        spellInfo.originalSpellName = spell->GetName();
-                        for (auto& effect : spell->effects) {
-                            spellEffectsBySpellEffectFormID.emplace(effect->baseEffect->GetFormID(), spell);
-                            spellInfosBySpellItem.emplace(spell, spellInfo);
-                            Log("Saving spell effect {} for spell {}", effect->baseEffect->GetName(), spell->GetName());
-                        }
-                        found++;
-                        break;
-                    }
-                }
-            }
-        }
+        // Cheapest checks first: most books in a large load order are not from any progression source
+        const auto source = FindProgressionSourceOfForm(book->GetFormID());
+        if (!source) continue;
+        if (!book->TeachesSpell()) continue;
+
+        auto* spell = book->GetSpell();
+        // Each name is logged up to its first 63 characters
+        LogDebug("Found {} spell book '{}' grants spell '{}'", progressionSources[*source].name, book->GetName(), spell->GetName());
+
+        auto slot = spellRegistry.FindByBookName(*source, book->fullName.c_str());
+        if (!slot) continue;
+
+        LogDebug("Matched this spell book with spell index {}", spellRegistry.spellIndexes[*slot]);
+        BindSpell(*slot, spell);
+        for (auto& effect : spell->effects) LogTrace("Saving spell effect {} for spell {}", effect->baseEffect->GetName(), spell->GetName());
+        found++;
     }
-    Log("Found {} out of {} Forgotten Magic spell books", found, spellInfosByIndex.size());
+    FinishBindingSpells();
+    LogInfo("Found {} out of {} spell books across {} progression sources", found, spellRegistry.Size(), progressionSources.size());
 }
 
-class MagicEffectApplyEventSink : public RE::BSTEventSink<RE::TESMagicEffectApplyEvent> {
-    // Mutex for protecting access to the spell queue and last use times
-    // Ensures thread-safe operations on the collection of spells pending processing
-    std::mutex queue_mutex;
+// Starts capturing every magic effect event if [Capture] enabled is set
+void ConfigureCapture() {
+    if (!iniSettings.GetBool("Capture", "enabled", false)) return;
 
-    // Mutex for ensuring only one batch of spells can be processed at a time
-    // Controls access to the is_processing flag
-    std::mutex processing_mutex;
+    std::vector<ForgottenMagic::EventCapture::Effect> effects;
+    for (const auto& [effectFormID, slot] : spellRegistry.EffectFormIDs()) effects.push_back({effectFormID, slot});
 
-    // Condition variable for signaling when new spells are added to the queue
-    // Used to wake up the background thread when there's work to do
-    std::condition_variable cv;
+    const auto filename   = iniSettings.GetString("Capture", "output_file", DEFAULT_CAPTURE_FILENAME);
+    const auto maxRecords = static_cast<std::uint64_t>(std::max(1l, iniSettings.GetLong("Capture", "max_records", 262144)));
+    if (eventCapture.Open(filename, maxRecords, effects)) LogInfo("[Capture] Capturing up to {} events to {}", maxRecords, filename);
+    else LogWarn("[Capture] Could not create capture file {}", filename);
+}
 
-    // Condition variable for signaling when spell processing is complete
-    // Used to coordinate waiting for processing to finish before starting new work
-    std::condition_variable processing_cv;
+// Reads [PapyrusApi] cast_events (on, off or auto)
+void ConfigureCastEvents() {
+    const auto mode = iniSettings.GetString("PapyrusApi", "cast_events", "auto");
+    if (mode == "on") castEvents = CastEvents::On;
+    else if (mode == "off") castEvents = CastEvents::Off;
+    else if (mode == "auto") castEvents = CastEvents::Auto;
+    else LogWarn("[INI] Unknown cast_events '{}', using auto", mode);
+}
 
-    // Queue of spells waiting to be processed (not actively used in current implementation)
-    // Kept for potential future use if immediate processing is needed
-    std::queue<RE::SpellItem*> spell_queue;
+// Enables metrics if [Metrics] enabled is set, labelling each spell by its original name
+void ConfigureMetrics() {
+    const auto enabled = iniSettings.GetBool("Metrics", "enabled", false);
+    metrics.Configure(enabled, spellRegistry.Size());
+    if (!enabled) return;
+
+    std::vector<std::string> labels;
+    labels.reserve(spellRegistry.Size());
+    for (SpellSlot slot = 0; slot < spellRegistry.Size(); slot++)
+        labels.push_back(spellRegistry.originalNames[slot].empty() ? spellRegistry.grantingBookNames[slot] : spellRegistry.originalNames[slot]);
+
+    const auto filename      = iniSettings.GetString("Metrics", "output_file", DEFAULT_METRICS_FILENAME);
+    const auto flushInterval = std::chrono::seconds(std::max(1l, iniSettings.GetLong("Metrics", "flush_interval_seconds", 60)));
+    metrics.StartReporter(filename, flushInterval, std::move(labels));
+    LogInfo("[Metrics] Writing metrics to {} every {}s", filename, flushInterval.count());
+}
 
-    // Maps spells to the timestamp of their last use
-    // Used to track when spells haven't been used for the required time (1 second)
-    std::unordered_map<RE::SpellItem*, std::chrono::steady_clock::time_point> last_use_times;
+/**
+ * Reads a debounce policy from an INI section, using fallback for any missing key
+ *
+ * policy is fixed, max_latency or adaptive; durations are in milliseconds.
+ */
+ForgottenMagic::DebouncePolicy ReadDebouncePolicy(std::string_view section, const ForgottenMagic::DebouncePolicy& fallback) {
+    using ForgottenMagic::DebouncePolicy;
+    auto milliseconds = [&](std::string_view key, DebouncePolicy::Clock::duration defaultValue) -> DebouncePolicy::Clock::duration {
+        const auto defaultMs = std::chrono::duration_cast<std::chrono::milliseconds>(defaultValue).count();
+        return std::chrono::milliseconds(std::max(0l, iniSettings.GetLong(section, key, static_cast<long>(defaultMs))));
+    };
+
+    auto       policy = fallback;
+    const auto fallbackKind =
+        fallback.window == DebouncePolicy::Window::Adaptive ? "adaptive" : (fallback.maxLatency > DebouncePolicy::Clock::duration::zero() ? "max_latency" : "fixed");
+    const auto kind = iniSettings.GetString(section, "policy", fallbackKind);
+
+    policy.quietPeriod    = milliseconds("quiet_period_ms", fallback.quietPeriod);
+    policy.minQuietPeriod = milliseconds("min_quiet_period_ms", fallback.minQuietPeriod);
+    policy.gapMultiplier  = static_cast<float>(iniSettings.GetDouble(section, "gap_multiplier", fallback.gapMultiplier));
+    policy.maxLatency     = milliseconds("max_latency_ms", fallback.maxLatency);
+
+    if (kind == "fixed") {
+        policy.window     = DebouncePolicy::Window::Fixed;
+        policy.maxLatency = {};
+    } else if (kind == "max_latency") {
+        policy.window = DebouncePolicy::Window::Fixed;
+        if (policy.maxLatency == DebouncePolicy::Clock::duration::zero()) policy.maxLatency = 3 * policy.quietPeriod;
+    } else if (kind == "adaptive") {
+        policy.window = DebouncePolicy::Window::Adaptive;
+    } else {
+        LogWarn("[INI] Unknown debounce policy '{}' in [{}], using {}", kind, section, fallbackKind);
+        return fallback;
+    }
+    return policy;
+}
 
-    // Background thread that monitors for spells to process and handles processing
-    // Runs continuously until the plugin is unloaded
-    std::thread background_thread;
+/**
+ * Reads [Debounce] for every spell, then the [Debounce.<source>.<spell index>] overrides
+ *
+ * With a single source, [Debounce.<spell index>] is accepted too. Only the override sections
+ * present are visited, so this does not grow with the size of the catalog.
+ */
+std::vector<ForgottenMagic::DebouncePolicy> ReadDebouncePolicies() {
+    constexpr auto DEBOUNCE_SECTION_PREFIX = "Debounce."sv;
+    const auto     defaultPolicy           = ReadDebouncePolicy("Debounce", ForgottenMagic::DebouncePolicy::Fixed(SPELL_QUIET_PERIOD));
+
+    std::vector<std::string> sections;
+    for (const auto& [qualifiedKey, value] : iniSettings.All()) {
+        // Keys of [Debounce] itself ("Debounce.policy") also start with the prefix, but their section name is shorter than it
+        const std::string_view key       = qualifiedKey;
+        const auto             separator = key.rfind('.');
+        if (key.starts_with(DEBOUNCE_SECTION_PREFIX) && separator >= DEBOUNCE_SECTION_PREFIX.size()) sections.emplace_back(key.substr(0, separator));
+    }
+    std::ranges::sort(sections);
+    sections.erase(std::ranges::unique(sections).begin(), sections.end());
+
+    std::vector<ForgottenMagic::DebouncePolicy> policies(spellRegistry.Size(), defaultPolicy);
+    for (const auto& section : sections) {
+        std::string_view spellName = section;
+        spellName.remove_prefix(DEBOUNCE_SECTION_PREFIX.size());
+
+        const auto              separator = spellName.rfind('.');
+        std::optional<SourceId> source    = progressionSources.size() == 1 ? std::optional<SourceId>(0) : std::nullopt;
+        SpellIndex              spellIndex;
+        if (separator != std::string_view::npos) {
+            source = FindProgressionSource(spellName.substr(0, separator));
+            spellName.remove_prefix(separator + 1);
+        }
+        const auto [end, error] = std::from_chars(spellName.data(), spellName.data() + spellName.size(), spellIndex);
+        const auto slot         = source && error == std::errc{} ? spellRegistry.FindBySpellIndex(*source, spellIndex) : std::nullopt;
+        if (!slot) {
+            LogWarn("[INI] [{}] does not name a tracked spell", section);
+            continue;
+        }
+        policies[*slot] = ReadDebouncePolicy(section, defaultPolicy);
+    }
+    return policies;
+}
 
-    // Flag indicating whether the background thread should continue running
-    // Set to false when the plugin is being unloaded to gracefully terminate the thread
-    std::atomic<bool> running{true};
+/**
+ * [XpMirror]: predict XP natively from casts instead of reading the Papyrus arrays every batch
+ */
+struct XpMirrorSettings {
+    bool                                enabled{false};
+    std::vector<float>                  xpPerCast;  // By SourceId
+    std::chrono::milliseconds           castWindow{};
+    std::chrono::steady_clock::duration reconcileInterval{};
+    std::chrono::milliseconds           quietPeriod{};
+};
+
+// Reads [XpMirror], and each source's xp_per_cast from [XpMirror.<source>]
+XpMirrorSettings ReadXpMirrorSettings() {
+    XpMirrorSettings settings;
+    settings.enabled          = iniSettings.GetBool("XpMirror", "enabled", false);
+    const auto defaultPerCast = iniSettings.GetDouble("XpMirror", "xp_per_cast", 1.0);
+    for (const auto& source : progressionSources)
+        settings.xpPerCast.push_back(static_cast<float>(iniSettings.GetDouble("XpMirror." + source.name, "xp_per_cast", defaultPerCast)));
+    settings.castWindow        = std::chrono::milliseconds(std::max(0l, iniSettings.GetLong("XpMirror", "cast_window_ms", 250)));
+    settings.reconcileInterval = std::chrono::seconds(std::max(1l, iniSettings.GetLong("XpMirror", "reconcile_interval_seconds", 30)));
+    settings.quietPeriod       = std::chrono::milliseconds(std::max(0l, iniSettings.GetLong("XpMirror", "quiet_period_ms", 50)));
+    return settings;
+}
+
+/**
+ * A progression source's MCM script object and its XP/points array properties, resolved once and reused by every batch
+ *
+ * Resolving walks the VM's attached scripts and looks up three properties by name, so it is
+ * only repeated after Invalidate (on game load and new game) or when the cached script turns
+ * out to have been detached from the quest.
+ */
+class McmScriptBinding {
+    const ProgressionSource& source;
+
+    RE::BSTSmartPointer<RE::BSScript::Object> script;
+    RE::VMHandle                              scriptHandle{0};
+    RE::BSScript::Variable*                   xpBySpellIdProperty{nullptr};
+    RE::BSScript::Variable*                   xpReqProperty{nullptr};
+    RE::BSScript::Variable*                   availablePointsProperty{nullptr};
+
+    // Set by Invalidate from the game thread, checked by whichever thread resolves next
+    std::atomic<bool> invalidated{true};
+
+    std::uint64_t hits{0};
+    std::uint64_t misses{0};
+
+    void Clear() {
+        script.reset();
+        scriptHandle            = 0;
+        xpBySpellIdProperty     = nullptr;
+        xpReqProperty           = nullptr;
+        availablePointsProperty = nullptr;
+    }
+
+    // Finds the first script attached to the MCM quest which has all three array properties
+    bool Bind() {
+        auto* vm                 = RE::BSScript::Internal::VirtualMachine::GetSingleton();
+        auto* objectHandlePolicy = vm->GetObjectHandlePolicy();
+        auto  mcmScriptHandle    = objectHandlePolicy->GetHandleForObject(source.quest->GetFormType(), source.quest);
+        auto  mcmAttachedScripts = vm->attachedScripts.find(mcmScriptHandle);
+        if (mcmAttachedScripts == vm->attachedScripts.end()) {
+            LogWarn("[{}] MCM quest has no attached scripts!", source.name);
+            return false;
+        }
+
+        for (const auto& attachedScript : mcmAttachedScripts->second) {
+            auto* xpBySpellId = attachedScript->GetProperty(source.xpProperty);
+            if (!xpBySpellId) {
+                LogWarn("[{}] {} property not found!", source.name, source.xpProperty);
+                continue;
+            }
+            auto* xpReq = attachedScript->GetProperty(source.xpRequirementProperty);
+            if (!xpReq) {
+                LogWarn("[{}] {} property not found!", source.name, source.xpRequirementProperty);
+                continue;
+            }
+            auto* availablePoints = attachedScript->GetProperty(source.pointsProperty);
+            if (!availablePoints) {
+                LogWarn("[{}] {} property not found!", source.name, source.pointsProperty);
+                continue;
+            }
 
-    // Flag indicating whether spell processing is currently in progress
-    // Used to prevent multiple batches of spells from being processed simultaneously
-    bool is_processing{false};
+            // And each property should be an array
+            if (!xpBySpellId->IsArray()) {
+                LogWarn("[{}] {} property is not an array!", source.name, source.xpProperty);
+                continue;
+            }
+            if (!xpReq->IsArray()) {
+                LogWarn("[{}] {} property is not an array!", source.name, source.xpRequirementProperty);
+                continue;
+            }
+            if (!availablePoints->IsArray()) {
+                LogWarn("[{}] {} property is not an array!", source.name, source.pointsProperty);
+                continue;
+            }
+
+            script                  = attachedScript;
+            scriptHandle            = attachedScript->GetHandle();
+            xpBySpellIdProperty     = xpBySpellId;
+            xpReqProperty           = xpReq;
+            availablePointsProperty = availablePoints;
+            return true;
+        }
+        return false;
+    }
 
 public:
+    explicit McmScriptBinding(const ProgressionSource& progressionSource) : source(progressionSource) {}
+
     /**
-     * Processes a batch of spells after they've been used and sufficient time has passed
-     *
-     * This function is called by the background thread with a batch of spells that
-     * haven't been used for at least 1 second. It's responsible for updating spell
-     * progress, XP, and any other necessary modifications.
+     * Makes the next Resolve look everything up again
      *
-     * Only one instance of this function can run at a time due to the processing_mutex
-     * and is_processing flag.
+     * Called whenever the game's script objects may have been replaced: on game load and new game.
+     */
+    void Invalidate() { invalidated = true; }
+
+    /**
+     * Makes sure the script and its properties are resolved, reusing the cached binding when it is still valid
      *
-     * @param spells A vector of spells to be processed in this batch
+     * @return Whether the three array properties are available
      */
-    void UpdateSpellsXP(const std::vector<RE::SpellItem*>& spells) {
-        Log("Processing batch of {} spells to update for XP", spells.size());
+    bool Resolve() {
+        if (!invalidated.exchange(false) && script) {
+            // A detached script no longer has the handle it was bound with
+            if (script->GetHandle() == scriptHandle) {
+                hits++;
+                return true;
+            }
+            LogInfo("[Papyrus] {} MCM script was detached, resolving it again", source.name);
+        }
 
-        // This is where we'd find the MCM script instance and call functions to update spell XP
-        auto* vm                 = RE::BSScript::Internal::VirtualMachine::GetSingleton();
-        auto* objectHandlePolicy = vm->GetObjectHandlePolicy();
-        auto  mcmScriptHandle    = objectHandlePolicy->GetHandleForObject(mcmQuest->GetFormType(), mcmQuest);
-        auto  mcmAttachedScripts = vm->attachedScripts.find(mcmScriptHandle);
-        if (mcmAttachedScripts != vm->attachedScripts.end()) {
-            for (const auto& script : mcmAttachedScripts->second) {
-                //
-
-                auto* xpBySpellIdProperty = script->GetProperty(PAPYRUS_XP_TRACKER_ARRAY);
-                if (!xpBySpellIdProperty) {
-                    Log("fSPXP property not found!");
-                    break;
-                }
-                auto* xpReqProperty = script->GetProperty(PAPYRUS_XP_REQUIREMENT_ARRAY);
-                if (!xpReqProperty) {
-                    Log("fXPreq property not found!");
-                    break;
-                }
-                auto* availablePointsProperty = script->GetProperty(PAPYRUS_POINTS_AVAILABLE_ARRAY);
-                if (!availablePointsProperty) {
-                    Log("iPoints property not found!");
-                    break;
-                }
+        misses++;
+        Clear();
+        auto bound = Bind();
+        LogInfo("[Papyrus] Resolved {} MCM script properties: {} ({} hits, {} misses)", source.name, bound ? "found" : "not found", hits, misses);
+        return bound;
+    }
 
-                // And each property should be an array
-                if (!xpBySpellIdProperty->IsArray()) {
-                    Log("fSPXP property is not an array!");
-                    break;
-                }
-                if (!xpReqProperty->IsArray()) {
-                    Log("fXPreq property is not an array!");
-                    break;
-                }
-                if (!availablePointsProperty->IsArray()) {
-                    Log("iPoints property is not an array!");
-                    break;
-                }
+    std::uint64_t Hits() const { return hits; }
+    std::uint64_t Misses() const { return misses; }
 
-                // Get the arrays
-                auto xpBySpellIdArray     = xpBySpellIdProperty->GetArray();
-                auto xpReqsBySpellIdArray = xpReqProperty->GetArray();
-                auto availablePointsArray = availablePointsProperty->GetArray();
+    RE::BSScript::Variable* XpBySpellIdProperty() const { return xpBySpellIdProperty; }
+    RE::BSScript::Variable* XpReqProperty() const { return xpReqProperty; }
+    RE::BSScript::Variable* AvailablePointsProperty() const { return availablePointsProperty; }
+};
 
-                for (const auto& spell : spells) {
-                    auto&      spellInfo  = spellInfosBySpellItem[spell];
-                    const auto spellIndex = spellInfo.spellIndex;
+/**
+ * XP source reading one progression source's XP, XP requirement and points arrays (fSPXP, fXPreq
+ * and iPoints for Forgotten Magic) through its cached binding
+ */
+class PapyrusXpSource : public ForgottenMagic::IXpSource {
+    McmScriptBinding binding;
 
-                    // Make sure the spell index is valid in both arrays
-                    if (xpBySpellIdArray->size() <= spellIndex) {
-                        Log("XP array size is smaller than spell index!");
-                        break;
-                    }
-                    if (xpReqsBySpellIdArray->size() <= spellIndex) {
-                        Log("XP req array size is smaller than spell index!");
-                        break;
-                    }
-                    if (availablePointsArray->size() <= spellIndex) {
-                        Log("Available points array size is smaller than spell index!");
-                        break;
-                    }
+public:
+    explicit PapyrusXpSource(const ProgressionSource& source) : binding(source) {}
 
-                    // Get the variable at the right spell index
-                    auto currentXpVariable = (*xpBySpellIdArray)[spellIndex];
-                    auto xpReqVariable     = (*xpReqsBySpellIdArray)[spellIndex];
-                    auto availablePoints   = (*availablePointsArray)[spellIndex];
+    McmScriptBinding& Binding() { return binding; }
 
-                    // Both need to be floats
-                    if (!currentXpVariable.IsFloat()) {
-                        Log("XP variable is not a float!");
-                        break;
-                    }
-                    if (!xpReqVariable.IsFloat()) {
-                        Log("XP req variable is not a float!");
-                        break;
-                    }
+    bool Capture(ForgottenMagic::XpSnapshot& snapshot) override {
+        Arrays arrays;
+        if (!GetArrays(arrays)) return false;
 
-                    // And the available points should be an int
-                    if (!availablePoints.IsInt()) {
-                        Log("Available points variable is not an int!");
-                        break;
-                    }
+        // Indexes missing from any of the arrays stay marked as out of bounds
+        snapshot.Reset(arrays.SnapshotSize());
+        for (SpellIndex i = 0; i < arrays.Size(); i++) arrays.Copy(snapshot, i);
+        return true;
+    }
 
-                    // Get the float values
-                    auto currentXp = currentXpVariable.GetFloat();
-                    auto xpReq     = xpReqVariable.GetFloat();
-                    if (currentXp < 0) {
-                        Log("XP is negative!");
-                        break;
-                    }
-                    if (xpReq <= 0) {
-                        Log("XP req is negative or zero!");
-                        break;
-                    }
+    bool Capture(ForgottenMagic::XpSnapshot& snapshot, std::span<const SpellIndex> spellIndexes) override {
+        Arrays arrays;
+        if (!GetArrays(arrays)) return false;
 
-                    // And get the int for the available points
-                    auto availablePointsInt = availablePoints.GetUInt();
-
-                    // Sweet! Now we can calculate the progress:
-                    auto progress = (currentXp / xpReq) * 100;
-                    Log("Progress: {} ({} / {})", progress, currentXp, xpReq);
-
-                    // Get it as a percentage, and clamp it to 0-100
-                    auto progressInt = static_cast<std::int32_t>(progress);
-                    if (progressInt < 0) progressInt = 0;
-                    if (progressInt > 100) progressInt = 100;
-
-                    // Get the original name of this form:
-                    auto originalName = spellInfo.originalSpellName;
-                    if (originalName.empty()) break;
-
-                    std::string availablePointsIndicator;
-                    availablePointsIndicator = std::string(availablePointsInt, '*');
-
-                    // If it's zero, then set the name back to the original name
-                    if (progressInt == 0) {
-                        spell->SetFullName(std::format("{}{}", originalName, availablePointsIndicator).c_str());
-                        Log("Setting name back to original for spell: {}", spell->GetFullName());
-                    } else {
-                        // Otherwise, set the name to the original name + progress
-                        // Make a new name which is the original name + progress, like
-                        // "<original name> (<progress>%)"
-                        auto newName = std::format("{} ({}%){}", originalName, progressInt, availablePointsIndicator);
-                        spell->SetFullName(newName.c_str());
-                        Log("Setting new name for spell: {}", newName);
-                    }
-                }
+        snapshot.Reset(arrays.SnapshotSize(), spellIndexes);
+        for (const auto i : spellIndexes)
+            if (i < arrays.Size()) arrays.Copy(snapshot, i);
+        return true;
+    }
+
+private:
+    struct Arrays {
+        RE::BSTSmartPointer<RE::BSScript::Array> xp;
+        RE::BSTSmartPointer<RE::BSScript::Array> xpReq;
+        RE::BSTSmartPointer<RE::BSScript::Array> points;
+
+        // Indexes present in all three arrays, and in any of them
+        std::size_t Size() const { return std::min({xp->size(), xpReq->size(), points->size()}); }
+        std::size_t SnapshotSize() const { return std::max({xp->size(), xpReq->size(), points->size()}); }
+
+        // Copies one index out of the Papyrus variables, recording type mismatches
+        void Copy(ForgottenMagic::XpSnapshot& snapshot, SpellIndex i) const {
+            using ForgottenMagic::XpSnapshot;
+            snapshot.MarkPresent(i);
+            if ((*xp)[i].IsFloat()) snapshot.SetXp(i, (*xp)[i].GetFloat());
+            else snapshot.MarkInvalid(i, XpSnapshot::XP_NOT_FLOAT);
+            if ((*xpReq)[i].IsFloat()) snapshot.SetXpReq(i, (*xpReq)[i].GetFloat());
+            else snapshot.MarkInvalid(i, XpSnapshot::XP_REQ_NOT_FLOAT);
+            if ((*points)[i].IsInt()) snapshot.SetPoints(i, (*points)[i].GetSInt());
+            else snapshot.MarkInvalid(i, XpSnapshot::POINTS_NOT_INT);
+        }
+    };
+
+    // Gets the arrays, straight from the MCM script's properties if they are already resolved
+    bool GetArrays(Arrays& arrays) {
+        if (!binding.Resolve()) return false;
+        arrays.xp     = binding.XpBySpellIdProperty()->GetArray();
+        arrays.xpReq  = binding.XpReqProperty()->GetArray();
+        arrays.points = binding.AvailablePointsProperty()->GetArray();
+        if (!arrays.xp || !arrays.xpReq || !arrays.points) {
+            LogWarn("MCM script arrays are not initialized!");
+            return false;
+        }
+        return true;
+    }
+};
+
+// XP source of each progression source, by SourceId; created once the sources' quests are found
+std::vector<std::unique_ptr<PapyrusXpSource>> papyrusXpSources;
+
+// Makes every source's binding resolve its script again (game load and new game)
+void InvalidateMcmScriptBindings() {
+    for (auto& xpSource : papyrusXpSources) xpSource->Binding().Invalidate();
+}
+
+// A spell's rendered state, as read back from the co-save
+struct RenderedNameState {
+    SpellSlot     slot;
+    std::int32_t  progress;
+    std::uint32_t points;
+};
+
+/**
+ * Saves the last rendered (progress, points) of every spell in the SKSE co-save, so that a
+ * loaded game shows its progress names straight away instead of after the warm-up's sweep
+ * of the Papyrus arrays. See ForgottenMagic::RenderedNames for the record's layout.
+ */
+namespace CoSave {
+    constexpr std::uint32_t UNIQUE_ID      = 0x464D'554E;  // 'FMUN'
+    constexpr std::uint32_t RENDERED_NAMES = 0x524E'4452;  // 'RNDR'
+
+    // Read by the load callback, handed to the warm-up by OnPostLoadGame (main thread)
+    std::vector<RenderedNameState> restoredNames;
+
+    void Save(SKSE::SerializationInterface* serialization) {
+        if (spellRegistry.Size() == 0) return;
+        const auto startedAt = std::chrono::steady_clock::now();
+
+        std::vector<ForgottenMagic::RenderedNames::Source> sources;
+        std::size_t                                        entryCount = 0;
+        for (SourceId source = 0; source < progressionSources.size(); source++) {
+            const auto [first, last] = spellRegistry.SourceSlots(source);
+            auto&      saved         = sources.emplace_back(progressionSources[source].name, std::vector<ForgottenMagic::RenderedNames::Entry>{});
+            for (auto slot = first; slot < last; slot++) {
+                const auto [progress, points] = spellRegistry.PublishedRenderState(slot);
+                if (!spellRegistry.spells[slot] || (progress <= 0 && points == 0)) continue;
+                saved.entries.push_back({spellRegistry.spellIndexes[slot], static_cast<std::uint16_t>(std::min<std::uint32_t>(points, UINT16_MAX)),
+                                         static_cast<std::uint8_t>(std::clamp(progress, 0, 100)), 0});
             }
+            entryCount += saved.entries.size();
+        }
+
+        const auto bytes = ForgottenMagic::RenderedNames::Encode(sources);
+        if (!serialization->OpenRecord(RENDERED_NAMES, ForgottenMagic::RenderedNames::VERSION) ||
+            !serialization->WriteRecordData(bytes.data(), static_cast<std::uint32_t>(bytes.size()))) {
+            LogError("[CoSave] Could not write the rendered names of {} spells", entryCount);
+            return;
         }
+        const auto durationInUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startedAt).count();
+        LogInfo("[CoSave] Saved the rendered names of {} spells ({} bytes) in {}us", entryCount, bytes.size(), durationInUs);
+    }
+
+    void Load(SKSE::SerializationInterface* serialization) {
+        restoredNames.clear();
+        std::uint32_t type, version, length;
+        while (serialization->GetNextRecordInfo(type, version, length)) {
+            if (type != RENDERED_NAMES) continue;
 
-        // Signal that processing is complete by setting is_processing to false
-        // and notifying any waiting threads that they can now process new batches
+            std::vector<std::byte> bytes(length);
+            if (serialization->ReadRecordData(bytes.data(), length) != length) {
+                LogWarn("[CoSave] Rendered names record is truncated");
+                continue;
+            }
+            const auto sources = ForgottenMagic::RenderedNames::Decode(bytes, version);
+            if (!sources) {
+                LogWarn("[CoSave] Ignoring unreadable rendered names record (version {}, {} bytes)", version, length);
+                continue;
+            }
+
+            // Sources or spell indexes which are no longer configured are dropped; their spells are refreshed by the warm-up
+            for (const auto& saved : *sources) {
+                const auto source = FindProgressionSource(saved.name);
+                if (!source) continue;
+                for (const auto& entry : saved.entries)
+                    if (auto slot = spellRegistry.FindBySpellIndex(*source, entry.spellIndex); slot && spellRegistry.spells[*slot])
+                        restoredNames.push_back({*slot, entry.progress, entry.points});
+            }
+        }
+        LogInfo("[CoSave] Read the rendered names of {} spells", restoredNames.size());
+    }
+
+    void Revert(SKSE::SerializationInterface*) { restoredNames.clear(); }
+
+    void Register() {
+        auto* serialization = SKSE::GetSerializationInterface();
+        serialization->SetUniqueID(UNIQUE_ID);
+        serialization->SetSaveCallback(Save);
+        serialization->SetLoadCallback(Load);
+        serialization->SetRevertCallback(Revert);
+    }
+}
+
+/**
+ * Name sink renaming the registry's SpellItems
+ *
+ * Only called on the main thread, by the NameApplyQueue from the once-per-frame hook.
+ */
+class SpellItemNameSink : public ForgottenMagic::INameSink {
+public:
+    void SetName(SpellSlot slot, const char* name) override {
+        spellRegistry.spells[slot]->SetFullName(name);
+        metrics.CountRename(slot);
+        LogDebug("Setting new name for spell: {}", name);  // Only the first 63 characters of the rendered name are logged
+    }
+};
+
+class MagicEffectApplyEventSink : public RE::BSTEventSink<RE::TESMagicEffectApplyEvent> {
+    // Lock-free hand-off of casts from ProcessEvent (any thread) to the background thread
+    // When its queue is full, casts of the same spell are coalesced instead of dropped
+    ForgottenMagic::SpellUseInbox spell_uses;
+
+    // Mutex used by the background thread to sleep on cv
+    // Producers only lock it to wake the background thread from an idle wait
+    std::mutex queue_mutex;
+
+    // Condition variable for signaling when new spells are added to the queue
+    // Used to wake up the background thread when it has nothing scheduled and a spell is cast
+    std::condition_variable cv;
+
+    // Deadline of each spell, so the background thread can sleep until the earliest one
+    // Only touched by the background thread
+    ForgottenMagic::DebounceScheduler debounce_scheduler{SPELL_QUIET_PERIOD};
+
+    // Background thread that monitors for spells to process and handles processing
+    // Runs continuously until the plugin is unloaded
+    std::thread background_thread;
+
+    // Flag indicating whether the background thread should continue running
+    // Set to false when the plugin is being unloaded to gracefully terminate the thread
+    std::atomic<bool> running{true};
+
+    // Reused by every batch to snapshot a source's arrays, compute progress and render names,
+    // and to group the batch's slots by source
+    ForgottenMagic::SpellNameUpdater name_updater;
+    std::vector<SpellSlot>           batch_slots;
+
+    // Native XP prediction of each source, read by batches instead of the Papyrus arrays once reconciled
+    // Only touched by the background thread
+    XpMirrorSettings                      xp_mirror_settings;
+    std::vector<ForgottenMagic::XpMirror> xp_mirrors;
+    ForgottenMagic::XpSnapshot            reconcile_snapshot;
+    std::chrono::steady_clock::time_point next_reconcile{std::chrono::steady_clock::time_point::max()};
+    std::uint64_t                         xp_drifts{0};
+
+    // Spells the MCM script reported as changed through the Papyrus API, which skip the debounce window
+    // pushed_spells is guarded by queue_mutex
+    std::vector<SpellSlot> pushed_spells;
+    std::atomic<bool>      push_pending{false};
+
+    // Rendered names are posted here and applied by the main thread within RENAME_FRAME_BUDGET per frame
+    // (see FrameHook), so SpellItems are never renamed while the game's menus may be reading them
+    ForgottenMagic::NameApplyQueue name_apply_queue;
+    SpellItemNameSink              name_sink;
+
+    // Load-time refresh requested by the game thread, picked up by the background thread
+    static constexpr std::uint8_t WARM_UP_RESET  = 1;  // Restore every spell's original name
+    static constexpr std::uint8_t WARM_UP_UPDATE = 2;  // Then refresh the player's spells in slices
+    std::atomic<std::uint8_t>     warm_up_request{0};
+
+    // The player's spells, collected on the game thread, and the names restored from the co-save,
+    // shown by the next warm-up before it refreshes anything
+    // Guarded by queue_mutex
+    std::vector<SpellSlot>         warm_up_requested_slots;
+    std::vector<RenderedNameState> warm_up_restored;
+
+    // Progress of the current warm-up: the player's spells, the next one to refresh and when its slice is due
+    // Only touched by the background thread
+    bool                                  warm_up_active{false};
+    std::vector<SpellSlot>                warm_up_slots;
+    std::size_t                           warm_up_next{0};
+    std::chrono::steady_clock::time_point warm_up_next_slice;
+    std::chrono::steady_clock::time_point warm_up_started;
+    std::size_t                           warm_up_refreshed{0};
+
+    // Restores the original name of every spell which is showing another one
+    void ResetSpellNames() {
+        for (SpellSlot slot = 0; slot < spellRegistry.Size(); slot++) {
+            if (spellRegistry.spells[slot] && !spellRegistry.nameRenderers[slot].ShowsOriginalName()) {
+                LogDebug("Resetting spell name to original: {}", spellRegistry.originalNames[slot]);
+                name_apply_queue.SetName(slot, spellRegistry.originalNames[slot].c_str());
+                spellRegistry.nameRenderers[slot].MarkOriginalName();
+                spellRegistry.PublishRenderState(slot);
+            }
+        }
+    }
+
+    void BeginWarmUp(std::uint8_t request, std::chrono::steady_clock::time_point now) {
+        ResetSpellNames();
+
+        // Show the names the save was made with right away; posting them replaces the resets still pending
+        std::vector<RenderedNameState> restored;
         {
-            std::lock_guard<std::mutex> lock(processing_mutex);
-            is_processing = false;       // Mark processing as complete
-            processing_cv.notify_all();  // Notify any waiting threads
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            restored.swap(warm_up_restored);
+            warm_up_slots.swap(warm_up_requested_slots);
+            warm_up_requested_slots.clear();
+        }
+        for (const auto& [slot, progress, points] : restored) {
+            if (auto* name = spellRegistry.nameRenderers[slot].Render(spellRegistry.originalNames[slot], progress, points)) name_apply_queue.SetName(slot, name);
+            spellRegistry.PublishRenderState(slot);
+        }
+
+        // Another game's XP: reseed the mirrors from the arrays right away, without counting it as drift
+        if (xp_mirror_settings.enabled) {
+            for (auto& xpMirror : xp_mirrors) xpMirror.Reset();
+            next_reconcile = now;
+        }
+
+        warm_up_active     = (request & WARM_UP_UPDATE) && !warm_up_slots.empty();
+        warm_up_next       = 0;
+        warm_up_next_slice = restored.empty() ? now : now + COSAVE_RECONCILE_DELAY;
+        warm_up_started    = now;
+        warm_up_refreshed  = 0;
+        if (!restored.empty()) {
+            const auto durationInUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - now).count();
+            LogInfo("[CoSave] Restored {} spell names in {}us; reconciling them with the Papyrus arrays in {}s", restored.size(), durationInUs,
+                    std::chrono::duration_cast<std::chrono::seconds>(COSAVE_RECONCILE_DELAY).count());
         }
+        if (warm_up_active) LogInfo("Refreshing the player's Forgotten Magic spells in slices of {}", WARM_UP_SLICE_SIZE);
+    }
 
-        Log("Batch processing complete");
+    /**
+     * Collects the next slice of the player's spells to refresh, if one is due
+     *
+     * @return Whether this was the last slice
+     */
+    bool CollectWarmUpSlice(std::chrono::steady_clock::time_point now, std::vector<SpellSlot>& slice) {
+        if (!warm_up_active || now < warm_up_next_slice) return false;
+
+        const auto count = std::min(WARM_UP_SLICE_SIZE, warm_up_slots.size() - warm_up_next);
+        slice.insert(slice.end(), warm_up_slots.begin() + static_cast<std::ptrdiff_t>(warm_up_next), warm_up_slots.begin() + static_cast<std::ptrdiff_t>(warm_up_next + count));
+        warm_up_next += count;
+        warm_up_refreshed += count;
+        warm_up_next_slice = now + WARM_UP_SLICE_INTERVAL;
+        warm_up_active     = warm_up_next < warm_up_slots.size();
+        return !warm_up_active;
+    }
+
+    /**
+     * Replaces each source's XP mirror with its Papyrus arrays, counting the spells it had wrong
+     *
+     * @param drifted Receives the slots of those spells, to be renamed with the corrected values
+     */
+    void ReconcileXpMirrors(std::chrono::steady_clock::time_point now, std::vector<SpellSlot>& drifted) {
+        next_reconcile = now + xp_mirror_settings.reconcileInterval;
+        for (SourceId source = 0; source < xp_mirrors.size(); source++) {
+            if (!progressionSources[source].file || !papyrusXpSources[source]->Capture(reconcile_snapshot)) continue;
+
+            const auto seeding        = !xp_mirrors[source].Seeded();
+            const auto driftedIndexes = xp_mirrors[source].Reconcile(reconcile_snapshot);
+            for (const auto spellIndex : driftedIndexes)
+                if (auto slot = spellRegistry.FindBySpellIndex(source, spellIndex)) drifted.push_back(*slot);
+
+            xp_drifts += driftedIndexes.size();
+            metrics.Count(Metrics::XP_RECONCILES);
+            metrics.Add(Metrics::XP_DRIFTS, driftedIndexes.size());
+            if (seeding) LogInfo("[XpMirror] Seeded {} from its {} spell indexes", progressionSources[source].name, reconcile_snapshot.Size());
+            else if (!driftedIndexes.empty()) LogDebug("[XpMirror] Corrected {} drifted {} spells ({} in total)", driftedIndexes.size(), progressionSources[source].name, xp_drifts);
+        }
+    }
+
+    // When the background thread next has something to do: the earliest spell deadline, warm-up slice or XP mirror reconciliation
+    std::chrono::steady_clock::time_point NextWakeUp() const {
+        auto wakeUp = debounce_scheduler.Empty() ? std::chrono::steady_clock::time_point::max() : debounce_scheduler.NextDeadline();
+        if (warm_up_active) wakeUp = std::min(wakeUp, warm_up_next_slice);
+        if (xp_mirror_settings.enabled) wakeUp = std::min(wakeUp, next_reconcile);
+        return wakeUp;
+    }
+
+    /**
+     * Processes a batch of spells after they've been used and sufficient time has passed
+     *
+     * This function is called by the background thread with a batch of spells whose
+     * debounce window has passed, or with a slice of the load-time warm-up. It's
+     * responsible for updating spell progress, XP, and any other necessary modifications.
+     *
+     * Only the background thread calls it, so batches never overlap and it needs no lock of
+     * its own.
+     *
+     * @param slots The registry slots of the spells to be processed in this batch
+     */
+    void UpdateSpellsXP(const std::vector<SpellSlot>& slots) {
+        LogDebug("Processing batch of {} spells to update for XP", slots.size());
+        const auto startedAt = std::chrono::steady_clock::now();
+
+        // A source's slots are contiguous, so sorting the batch groups it into one run per source
+        batch_slots.assign(slots.begin(), slots.end());
+        std::ranges::sort(batch_slots);
+
+        ForgottenMagic::SpellNameUpdater::Result result;
+        for (auto first = batch_slots.begin(); first != batch_slots.end();) {
+            const auto source   = spellRegistry.sourceIds[*first];
+            const auto last     = std::find_if(first, batch_slots.end(), [source](SpellSlot slot) { return spellRegistry.sourceIds[slot] != source; });
+            auto&      papyrus  = *papyrusXpSources[source];
+
+            // The mirror, once reconciled, saves reading the Papyrus arrays
+            ForgottenMagic::IXpSource* xpSource = &papyrus;
+            if (xp_mirror_settings.enabled && xp_mirrors[source].Seeded()) xpSource = &xp_mirrors[source];
+
+            const auto sourceResult = name_updater.Update(std::span(first, last), spellRegistry.NameColumns(), *xpSource, name_apply_queue);
+            for (auto slot = first; slot != last; slot++) spellRegistry.PublishRenderState(*slot);
+            for (const auto& [slot, invalid] : name_updater.InvalidSpells())
+                LogWarn("Skipping {} spell index {}: invalid XP data (reasons {:#04x})", progressionSources[source].name, spellRegistry.spellIndexes[slot], invalid);
+            LogDebug("[Papyrus] {} MCM script binding cache: {} hits, {} misses", progressionSources[source].name, papyrus.Binding().Hits(), papyrus.Binding().Misses());
+
+            result.renamesIssued += sourceResult.renamesIssued;
+            result.renamesSkipped += sourceResult.renamesSkipped;
+            first = last;
+        }
+
+        spellRenamesIssued += result.renamesIssued;
+        spellRenamesSkipped += result.renamesSkipped;
+        LogDebug("Renamed {} spells and skipped {} unchanged spells ({} renamed, {} skipped in total)", result.renamesIssued, result.renamesSkipped, spellRenamesIssued.load(), spellRenamesSkipped.load());
+        LogDebug("[Rename] {} names applied over {} frames, {} coalesced", name_apply_queue.Applied(), name_apply_queue.Frames(), name_apply_queue.Coalesced());
+        metrics.Count(Metrics::BATCHES);
+        metrics.Record(Metrics::BATCH_DURATION, std::chrono::steady_clock::now() - startedAt);
+        LogDebug("Batch processing complete");
     }
 
     /**
      * Main function for the background thread that monitors spells and processes them
      *
      * This function runs in a continuous loop until the plugin is unloaded.
-     * It periodically checks for spells that haven't been used for at least 1 second,
-     * collects them into a batch, and processes them.
+     * It sleeps until the earliest spell deadline in the heap or the next warm-up slice
+     * (or indefinitely when there is neither), collects every spell whose deadline has
+     * passed, and processes them as one batch, followed by the warm-up slice if one is due.
      *
-     * The function has several synchronization points:
-     * 1. Waiting for new spells or checking existing ones (with timeout)
+     * The function has two synchronization points:
+     * 1. Sleeping until the next wake-up, until a spell with an earlier deadline is queued, or until a warm-up is requested
      * 2. Collecting spells that haven't been used for the required time
-     * 3. Waiting for any current processing to complete before starting new processing
      */
     void BackgroundThreadFunction() {
         while (running) {  // Main loop continues until plugin unload
-            // Collection of spells that are ready to be processed
-            std::vector<RE::SpellItem*> spells_to_process;
+            // Collection of spells that are ready to be processed, and the warm-up slice due now
+            std::vector<SpellSlot> spells_to_process;
+            std::vector<SpellSlot> pushed;
+            std::vector<SpellSlot> drifted_spells;
+            std::vector<SpellSlot> warm_up_slice;
+            auto                   warm_up_finished = false;
 
             // SECTION 1: Collect spells that haven't been used for the required time
             {
-                // Lock the queue to safely access last_use_times
-                std::unique_lock<std::mutex> lock(queue_mutex);
-
-                // Wait with timeout - either wakes up when a new spell is added
-                // or after 100ms to check existing spells
-                cv.wait_for(lock, std::chrono::milliseconds(100));
-
-                // Get current time to compare against last use times
-                auto now = std::chrono::steady_clock::now();
-
-                // Track spells that will be removed from the monitoring map
-                std::vector<RE::SpellItem*> spells_to_remove;
-
-                // Check each spell's last use time
-                for (auto& [spell, last_time] : last_use_times) {
-                    // Calculate time since last use
-                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_time).count();
-
-                    // If at least 1 second has passed since last use
-                    if (elapsed >= 1000) {
-                        spells_to_process.push_back(spell);  // Add to processing batch
-                        spells_to_remove.push_back(spell);   // Mark for removal from monitoring
+                // Sleep until there is something scheduled, then until the earliest deadline or warm-up slice.
+                // Casts arriving while we sleep only wake us if their spell's debounce policy could make
+                // them due before that deadline; every other cast is simply drained when we wake up.
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex);
+                    const auto                   sleepUntil = NextWakeUp();
+                    if (spell_uses.BeginSleep(sleepUntil)) {
+                        auto woken = [this] { return !running || !spell_uses.IsSleeping() || warm_up_request.load() || push_pending.load(); };
+                        if (sleepUntil == std::chrono::steady_clock::time_point::max()) cv.wait(lock, woken);
+                        else cv.wait_until(lock, sleepUntil, woken);
                     }
+                    spell_uses.EndSleep();
                 }
 
-                // Remove processed spells from the monitoring map
-                for (auto* spell : spells_to_remove) {
-                    last_use_times.erase(spell);
-                }
-            }  // queue_mutex is released here
+                // Exit if we're shutting down
+                if (!running) break;
 
-            // SECTION 2: Process collected spells if any were found
-            if (!spells_to_process.empty()) {
-                // Lock the processing mutex to check/update processing status
-                std::unique_lock<std::mutex> lock(processing_mutex);
+                // Move all casts recorded since the last wakeup into the scheduler, and predict the XP they earned
+                spell_uses.Drain([this](SpellSlot slot, std::chrono::steady_clock::time_point usedAt) {
+                    debounce_scheduler.Schedule(slot, usedAt);
+                    if (xp_mirror_settings.enabled) {
+                        const auto source = spellRegistry.sourceIds[slot];
+                        xp_mirrors[source].RecordEffect(spellRegistry.spellIndexes[slot], xp_mirror_settings.xpPerCast[source], usedAt);
+                    }
+                });
+
+                // A game was loaded or started: reset the names now, and refresh them in slices from here on
+                const auto now = std::chrono::steady_clock::now();
+                if (auto request = warm_up_request.exchange(0)) BeginWarmUp(request, now);
 
-                // Wait until any current processing is complete
-                // This ensures only one batch of spells is processed at a time
-                while (is_processing && running) {
-                    processing_cv.wait(lock);
+                // Spells the MCM script reported as changed are processed now. With the XP mirror, the
+                // mirror is reconciled instead, which renames every spell whose XP it did not predict.
+                if (push_pending.exchange(false)) {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    pushed.swap(pushed_spells);
+                }
+                if (!pushed.empty() && xp_mirror_settings.enabled) next_reconcile = now;
+
+                // Correct the XP mirrors against the Papyrus arrays, and rename the spells they had wrong
+                if (xp_mirror_settings.enabled && now >= next_reconcile) ReconcileXpMirrors(now, drifted_spells);
+
+                // Collect every spell whose deadline has passed
+                debounce_scheduler.PopDue(now, spells_to_process);
+                if (metrics.Enabled())
+                    for (auto slot : spells_to_process) metrics.RecordPickup(slot, now - debounce_scheduler.LastUse(slot));
+                if (!pushed.empty() && !xp_mirror_settings.enabled) {
+                    spells_to_process.insert(spells_to_process.end(), pushed.begin(), pushed.end());
+                    std::ranges::sort(spells_to_process);
+                    spells_to_process.erase(std::ranges::unique(spells_to_process).begin(), spells_to_process.end());
                 }
 
-                // Exit if we're shutting down
-                if (!running) break;
+                warm_up_finished = CollectWarmUpSlice(now, warm_up_slice);
+            }
 
-                // Mark as processing and release lock before actual processing
-                is_processing = true;
-                lock.unlock();
+            // SECTION 2: Process collected spells and the warm-up slice if any were found
+            for (const auto* batch : {&spells_to_process, &drifted_spells, &warm_up_slice})
+                if (!batch->empty()) UpdateSpellsXP(*batch);
 
-                // Process the batch of spells
-                UpdateSpellsXP(spells_to_process);
-                // Note: RunThisAfterTheMagicEffectIsDoneBeingUsed will reset is_processing when done
+            if (warm_up_finished) {
+                const auto durationInMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - warm_up_started).count();
+                LogInfo("Refreshed {} of the player's Forgotten Magic spells in {}ms", warm_up_refreshed, durationInMs);
             }
         }
     }
 
+public:
     /**
-     * Adds a spell to be monitored for processing
+     * Sizes the cast inbox and the scheduler for every spell in the registry, then starts the background thread
      *
-     * When a spell is used, this function is called to update its last use time.
-     * The spell will be processed after it hasn't been used for 1 second.
+     * Must be called once the spell data is loaded and before the event sink is registered.
      *
-     * @param spell The spell that was just used
+     * @param debouncePolicies The debounce policy of each registry slot
+     * @param xpMirror Whether and how to predict XP natively; the mirrors are first seeded when a game is loaded
      */
-    void QueueSpell(RE::SpellItem* spell) {
-        // Lock the queue to safely update last_use_times
-        std::lock_guard<std::mutex> lock(queue_mutex);
+    void Start(std::span<const ForgottenMagic::DebouncePolicy> debouncePolicies, XpMirrorSettings xpMirror) {
+        if (background_thread.joinable()) return;
+        xp_mirror_settings = std::move(xpMirror);
+        if (xp_mirror_settings.enabled) xp_mirrors.resize(progressionSources.size());
+        for (auto& xpMirror : xp_mirrors) xpMirror.SetCastWindow(xp_mirror_settings.castWindow);
+        spell_uses.Resize(debouncePolicies.size());
+        debounce_scheduler.Resize(debouncePolicies.size());
+        for (SpellSlot slot = 0; slot < debouncePolicies.size(); slot++) debounce_scheduler.SetPolicy(slot, debouncePolicies[slot]);
+        name_apply_queue.Configure(debouncePolicies.size(), name_sink, RENAME_FRAME_BUDGET);
 
-        // Update the spell's last use time to now
-        last_use_times[spell] = std::chrono::steady_clock::now();
+        // Start the background thread that will monitor and process spells
+        background_thread = std::thread(&MagicEffectApplyEventSink::BackgroundThreadFunction, this);
+    }
 
-        // Notify the background thread that there's a new/updated spell
+    /**
+     * Reports spells whose XP, requirement or points the progression mod changed (Papyrus thread)
+     *
+     * They skip the debounce window and are processed as soon as the background thread wakes up.
+     */
+    void PushXpChanged(std::span<const SpellSlot> slots) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            pushed_spells.insert(pushed_spells.end(), slots.begin(), slots.end());
+            push_pending = true;
+        }
         cv.notify_one();
     }
 
     /**
-     * Constructor - starts the background thread
+     * Asks the background thread to reset every spell's name, then to refresh the given spells of the player
+     *
+     * Called on game load and new game. The refresh runs on the background thread in slices of
+     * WARM_UP_SLICE_SIZE spells between cast-triggered batches, so this returns immediately and
+     * never adds to load time. A new request replaces a warm-up still in progress.
+     *
+     * @param playerSpells Slots of the spells the player knows, collected on the game thread (see PlayerSpellSlots)
+     * @param restored Names read from the save's co-save: they are shown as soon as the names are reset,
+     *                 and the refresh then starts only after COSAVE_RECONCILE_DELAY
      */
-    MagicEffectApplyEventSink() {
-        // Start the background thread that will monitor and process spells
-        background_thread = std::thread(&MagicEffectApplyEventSink::BackgroundThreadFunction, this);
+    void RequestWarmUp(std::vector<SpellSlot> playerSpells, std::vector<RenderedNameState> restored = {}) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            warm_up_request         = playerSpells.empty() ? WARM_UP_RESET : WARM_UP_RESET | WARM_UP_UPDATE;
+            warm_up_requested_slots = std::move(playerSpells);
+            warm_up_restored        = std::move(restored);
+        }
+        cv.notify_one();
+    }
+
+    /**
+     * Records that a spell was used so it can be processed once its debounce policy says it is due
+     *
+     * Called on the game's event dispatch thread. This never blocks: the cast is handed to the
+     * lock-free inbox, and queue_mutex is only taken when the background thread is sleeping
+     * past the earliest time this cast could become due and needs waking.
+     *
+     * @param slot The registry slot of the spell that was just used
+     */
+    void QueueSpell(SpellSlot slot) {
+        const auto now = std::chrono::steady_clock::now();
+        if (spell_uses.Record(slot, now, now + debounce_scheduler.MinimumDelay(slot))) {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            cv.notify_one();
+        }
     }
 
     /**
@@ -406,7 +1652,10 @@ public:
      */
     ~MagicEffectApplyEventSink() {
         // Signal the background thread to stop
-        running = false;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            running = false;
+        }
 
         // Wake up all waiting threads so they can check the running flag
         cv.notify_all();
@@ -417,6 +1666,9 @@ public:
         }
     }
 
+    // Applies the names posted since the last frame, within RENAME_FRAME_BUDGET (main thread, once per frame)
+    void ApplyPendingNames() { name_apply_queue.ApplyPending(); }
+
     /**
      * Singleton accessor - ensures only one instance exists
      *
@@ -431,75 +1683,172 @@ public:
      * Event handler for magic effect application events
      *
      * Called whenever a magic effect is applied in the game.
-     * Filters for Forgotten Magic effects and queues the corresponding spell for processing.
+     * Filters for Forgotten Magic effects using the precomputed effect filter and queues the corresponding spell for processing.
      *
      * @param event The magic effect application event
      * @param eventSource The source of the event
      * @return Control flag to continue processing other event handlers
      */
     RE::BSEventNotifyControl ProcessEvent(const RE::TESMagicEffectApplyEvent* event, RE::BSTEventSource<RE::TESMagicEffectApplyEvent>* eventSource) override {
-        // Get the form for the magic effect
-        auto* form = RE::TESForm::LookupByID(event->magicEffect);
-        if (!form) return RE::BSEventNotifyControl::kContinue;
-
-        // Check if Forgotten Magic plugin is loaded
-        if (!forgottenMagicFile) return RE::BSEventNotifyControl::kContinue;
+        metrics.Count(Metrics::EVENTS_SEEN);
+        if (eventCapture.IsOpen())
+            eventCapture.Append(event->magicEffect, event->caster ? event->caster->GetFormID() : 0, event->target ? event->target->GetFormID() : 0);
 
-        // Check if the magic effect belongs to the Forgotten Magic plugin
-        if (!forgottenMagicFile->IsFormInMod(event->magicEffect)) return RE::BSEventNotifyControl::kContinue;
+        // Once the MCM script reports XP changes itself, casts are no longer needed to guess them
+        if (!CastEventsEnabled()) return RE::BSEventNotifyControl::kContinue;
 
-        // Look up the spell associated with this magic effect
-        auto it = spellEffectsBySpellEffectFormID.find(event->magicEffect);
-        if (it != spellEffectsBySpellEffectFormID.end()) {
-            auto* spell = it->second;
-            Log("Found a Forgotten Magic spell was used: {}", spell->GetName());
+        // Reject every effect which does not belong to a tracked Forgotten Magic spell, and find the spell of one which does
+        if (auto slot = spellRegistry.FindByEffectFormID(event->magicEffect)) {
+            LogTrace("Found a Forgotten Magic spell was used: {}", spellRegistry.originalNames[*slot]);  // Copied into the record, truncated to 63 characters
+            metrics.CountEvent(*slot);
 
             // Queue the spell for monitoring and eventually processing
-            QueueSpell(spell);
+            QueueSpell(*slot);
         }
 
         return RE::BSEventNotifyControl::kContinue;
     }
 };
 
-void ResetAllSpellsToTheirOriginalNames() {
-    for (const auto& [spell, spellInfo] : spellInfosBySpellItem) {
-        if (spell && spellInfo.spell) {
-            Log("Resetting spell name to original: {}", spellInfo.originalSpellName);
-            spell->SetFullName(spellInfo.originalSpellName.c_str());
+/**
+ * Native functions of the ForgottenMagic_UpdateSpellsWithProgress script, which a patched MCM
+ * script calls when it changes a spell's XP so the spell is renamed without waiting for casts
+ */
+namespace PapyrusApi {
+    // The source named by a [Source.<name>] section, or the only source for ""
+    std::optional<SourceId> FindSource(std::string_view name) {
+        if (name.empty()) {
+            if (progressionSources.size() == 1) return SourceId{0};
+            LogWarn("[PapyrusApi] No source given, but there are {} progression sources", progressionSources.size());
+            return std::nullopt;
         }
+        auto source = FindProgressionSource(name);
+        if (!source) LogWarn("[PapyrusApi] Unknown progression source '{}'", name);
+        return source;
     }
-}
 
-void UpdateXPofAllSpells() {
-    Log("Updating XP for all of the player's Forgotten Magic spells...");
-    std::vector<RE::SpellItem*> allSpells;
-    const auto*                 player = RE::PlayerCharacter::GetSingleton();
-    for (const auto& [spell, spellInfo] : spellInfosBySpellItem) {
-        if (player->HasSpell(spell)) {
-            if (spell && spellInfo.spell) {
-                allSpells.push_back(spell);
-            }
+    void Push(std::span<const SpellSlot> slots) {
+        papyrusApiUsed = true;
+        metrics.Add(Metrics::XP_PUSHES, slots.size());
+        MagicEffectApplyEventSink::instance()->PushXpChanged(slots);
+    }
+
+    // Function SpellXpChanged(string source, int spellIndex) global native
+    void SpellXpChanged(RE::StaticFunctionTag*, RE::BSFixedString sourceName, std::int32_t spellIndex) {
+        const auto source = FindSource(sourceName.c_str());
+        if (!source || spellIndex < 0) return;
+        const auto slot = spellRegistry.FindBySpellIndex(*source, static_cast<SpellIndex>(spellIndex));
+        if (!slot || !spellRegistry.spells[*slot]) {
+            LogDebug("[PapyrusApi] {} spell index {} is not tracked", progressionSources[*source].name, spellIndex);
+            return;
         }
+        LogTrace("[PapyrusApi] {} spell index {} XP changed", progressionSources[*source].name, spellIndex);
+        Push(std::span(&*slot, 1));
+    }
+
+    // Function AllSpellsXpChanged(string source) global native
+    void AllSpellsXpChanged(RE::StaticFunctionTag*, RE::BSFixedString sourceName) {
+        const auto source = FindSource(sourceName.c_str());
+        if (!source) return;
+        const auto [first, last] = spellRegistry.SourceSlots(*source);
+        std::vector<SpellSlot> slots;
+        for (auto slot = first; slot < last; slot++)
+            if (spellRegistry.spells[slot]) slots.push_back(slot);
+        LogDebug("[PapyrusApi] All {} {} spells XP changed", slots.size(), progressionSources[*source].name);
+        Push(slots);
+    }
+
+    bool Register(RE::BSScript::IVirtualMachine* vm) {
+        vm->RegisterFunction("SpellXpChanged", PAPYRUS_API_SCRIPT, SpellXpChanged);
+        vm->RegisterFunction("AllSpellsXpChanged", PAPYRUS_API_SCRIPT, AllSpellsXpChanged);
+        LogInfo("[PapyrusApi] Registered native functions of {}", PAPYRUS_API_SCRIPT);
+        return true;
     }
-    MagicEffectApplyEventSink::instance()->UpdateSpellsXP(allSpells);
-    Log("Updated XP for all of the player's Forgotten Magic spells");
 }
 
-SKSEPlugin_Entrypoint { ParseIni(); }
+/**
+ * Calls into the plugin once per frame on the main thread, from the game's main loop
+ *
+ * Renames are spread over frames from here rather than through SKSE tasks: the task
+ * interface runs tasks added by its tasks in the same frame, so a task re-posting itself
+ * would never yield to the next frame.
+ */
+namespace FrameHook {
+    // Call to an empty function near the end of Main::Update, replaced with Update
+    REL::Relocation<void()> original;
+
+    void Update() {
+        original();
+        MagicEffectApplyEventSink::instance()->ApplyPendingNames();
+    }
+
+    void Install() {
+        REL::Relocation<std::uintptr_t> target{RELOCATION_ID(35565, 36564), REL::VariantOffset(0x748, 0xC26, 0x7EE)};
+        SKSE::AllocTrampoline(14);
+        original = SKSE::GetTrampoline().write_call<5>(target.address(), Update);
+    }
+}
+
+SKSEPlugin_Entrypoint {
+    asyncLog.Start(WriteLogLine);
+    ParseIni();
+    SKSE::GetPapyrusInterface()->Register(PapyrusApi::Register);
+    CoSave::Register();
+    FrameHook::Install();
+}
 
 SKSEPlugin_OnDataLoaded {
     const auto now = std::chrono::steady_clock::now();
-    if (LookupForgottenMagicPluginAndMCM()) {
-        if (forgottenMagicFile) LoadForgottenMagicSpellsData();
+    if (LookupProgressionSources()) {
+        for (const auto& source : progressionSources) papyrusXpSources.push_back(std::make_unique<PapyrusXpSource>(source));
+        if (!StartupCache::RestoreSpells()) {
+            LoadForgottenMagicSpellsData();
+            StartupCache::Save();
+        }
+        ConfigureMetrics();
+        ConfigureCapture();
+        ConfigureCastEvents();
+        auto xpMirror         = ReadXpMirrorSettings();
+        auto debouncePolicies = ReadDebouncePolicies();
+
+        // With the mirror a batch never touches Papyrus, so spells can be renamed right after they are cast
+        if (xpMirror.enabled) debouncePolicies.assign(debouncePolicies.size(), ForgottenMagic::DebouncePolicy::Fixed(xpMirror.quietPeriod));
+        MagicEffectApplyEventSink::instance()->Start(debouncePolicies, std::move(xpMirror));
         RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(MagicEffectApplyEventSink::instance());
     }
     const auto durationInMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - now).count();
-    Log("Data loaded in {}ms", durationInMs);
+    LogInfo("Data loaded in {}ms (startup cache {})", durationInMs, StartupCache::hit ? "hit" : "miss");
+}
+
+/**
+ * Slots of the Forgotten Magic spells the player knows; reads the player's spell list, so only call on the game thread
+ *
+ * Spell books add their spell to the player's added spells, so walking that list once and
+ * finding each spell's slot costs O(player spells × log catalog), where asking HasSpell of
+ * every slot scanned the list once per slot.
+ */
+std::vector<SpellSlot> PlayerSpellSlots() {
+    std::vector<SpellSlot> slots;
+    auto*                  player = RE::PlayerCharacter::GetSingleton();
+    if (!player) return slots;
+    for (const auto* spell : player->GetActorRuntimeData().addedSpells)
+        if (auto slot = spellRegistry.FindBySpell(spell)) slots.push_back(*slot);
+
+    // In slot order, as the warm-up expects, so its slices stay grouped by source
+    std::ranges::sort(slots);
+    slots.erase(std::ranges::unique(slots).begin(), slots.end());
+    return slots;
 }
 
 SKSEPlugin_OnPostLoadGame {
-    ResetAllSpellsToTheirOriginalNames();
-    UpdateXPofAllSpells();
+    const auto now = std::chrono::steady_clock::now();
+    InvalidateMcmScriptBindings();
+    MagicEffectApplyEventSink::instance()->RequestWarmUp(PlayerSpellSlots(), std::move(CoSave::restoredNames));
+    CoSave::restoredNames.clear();
+    const auto durationInUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - now).count();
+    LogInfo("Post-load refresh scheduled in {}us", durationInUs);
+}
+SKSEPlugin_OnNewGame {
+    InvalidateMcmScriptBindings();
+    MagicEffectApplyEventSink::instance()->RequestWarmUp({});
 }
-SKSEPlugin_OnNewGame { ResetAllSpellsToTheirOriginalNames(); }
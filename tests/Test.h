@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+/**
+ * Minimal harness for ForgottenMagicTests
+ *
+ * Each test is a function defined with FORGOTTEN_MAGIC_TEST, which registers it under its
+ * name. CHECK records a failure with its location and lets the test carry on; REQUIRE also
+ * returns from the test. main runs every test whose name contains one of the command line
+ * filters, and fails if any check did.
+ */
+namespace ForgottenMagic::Test {
+    struct Test {
+        const char* name;
+        void (*run)();
+    };
+
+    inline std::vector<Test>& Registry() {
+        static std::vector<Test> tests;
+        return tests;
+    }
+
+    struct Registration {
+        Registration(const char* name, void (*run)()) { Registry().push_back({name, run}); }
+    };
+
+    // Failed checks of the running test
+    inline int failures = 0;
+
+    inline bool Check(bool passed, const char* expression, const char* file, int line) {
+        if (passed) return true;
+        failures++;
+        std::printf("    %s:%d: CHECK(%s) failed\n", file, line, expression);
+        return false;
+    }
+}
+
+#define FORGOTTEN_MAGIC_TEST(name)                                                    \
+    static void name();                                                               \
+    static const ::ForgottenMagic::Test::Registration name##Registration(#name, name); \
+    static void name()
+
+#define CHECK(...) ::ForgottenMagic::Test::Check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+#define REQUIRE(...) \
+    if (!CHECK(__VA_ARGS__)) return
@@ -0,0 +1,145 @@
+// Replays synthetic cast patterns through DebounceScheduler on a simulated clock and reports,
+// for each debounce policy, how many times the spell would be renamed and how stale its name is
+
+#include <ForgottenMagic/DebounceScheduler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "Test.h"
+
+using namespace ForgottenMagic;
+using namespace std::chrono_literals;
+
+namespace {
+    using Clock = DebounceScheduler::Clock;
+
+    // Policies as the shipped INI configures them: [Debounce] defaults, and the cloak spells' cap
+    const DebouncePolicy FIXED       = DebouncePolicy::Fixed(1000ms);
+    const DebouncePolicy MAX_LATENCY = DebouncePolicy::MaxLatency(1000ms, 3000ms);
+    const DebouncePolicy ADAPTIVE    = DebouncePolicy::Adaptive(150ms, 1000ms, 2.0f);
+
+    struct Simulation {
+        std::vector<Clock::duration> updates;       // Since the first cast
+        std::vector<Clock::duration> updateDelays;  // From the latest cast before each update
+        Clock::duration              meanStaleness{};
+        Clock::duration              maxStaleness{};
+    };
+
+    // Casts one spell at the given offsets, popping due spells exactly at their deadlines, as the background thread does
+    Simulation Simulate(const DebouncePolicy& policy, const std::vector<Clock::duration>& casts) {
+        DebounceScheduler scheduler(1000ms);
+        scheduler.Resize(1);
+        scheduler.SetPolicy(0, policy);
+
+        const Clock::time_point      start{};
+        Simulation                   simulation;
+        std::vector<SpellHandle>     due;
+        std::vector<Clock::duration> pendingCasts;
+        Clock::duration              totalStaleness{};
+        std::size_t                  next = 0;
+        while (next < casts.size() || !scheduler.Empty()) {
+            if (!scheduler.Empty() && (next == casts.size() || scheduler.NextDeadline() <= start + casts[next])) {
+                const auto now = scheduler.NextDeadline();
+                due.clear();
+                scheduler.PopDue(now, due);
+                if (due.empty()) continue;
+
+                // Each cast's staleness is how long its XP change waited for the rename
+                const auto at = now - start;
+                for (auto cast : pendingCasts) {
+                    totalStaleness += at - cast;
+                    simulation.maxStaleness = std::max(simulation.maxStaleness, at - cast);
+                }
+                simulation.updates.push_back(at);
+                simulation.updateDelays.push_back(at - pendingCasts.back());
+                pendingCasts.clear();
+            } else {
+                scheduler.Schedule(0, start + casts[next]);
+                pendingCasts.push_back(casts[next++]);
+            }
+        }
+        simulation.meanStaleness = totalStaleness / static_cast<Clock::rep>(std::max<std::size_t>(casts.size(), 1));
+        return simulation;
+    }
+
+    void Print(std::string_view pattern, std::string_view policy, const Simulation& simulation) {
+        std::printf("    %-10.*s %-12.*s %4zu updates, staleness mean %6lld ms, max %6lld ms\n", static_cast<int>(pattern.size()), pattern.data(), static_cast<int>(policy.size()),
+                    policy.data(), simulation.updates.size(), static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(simulation.meanStaleness).count()),
+                    static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(simulation.maxStaleness).count()));
+    }
+
+    // A cloak spell's effect fires every 500ms for 10s
+    std::vector<Clock::duration> CloakCasts() {
+        std::vector<Clock::duration> casts;
+        for (auto at = 0ms; at < 10s; at += 500ms) casts.push_back(at);
+        return casts;
+    }
+
+    // A two-effect bolt cast every 3s: both effects apply 10ms apart
+    std::vector<Clock::duration> BoltCasts() {
+        std::vector<Clock::duration> casts;
+        for (auto at = 0ms; at < 60s; at += 3s) {
+            casts.push_back(at);
+            casts.push_back(at + 10ms);
+        }
+        return casts;
+    }
+
+    // A one-effect spell cast every 3s
+    std::vector<Clock::duration> OneShotCasts() {
+        std::vector<Clock::duration> casts;
+        for (auto at = 0ms; at < 60s; at += 3s) casts.push_back(at);
+        return casts;
+    }
+}
+
+FORGOTTEN_MAGIC_TEST(DebouncePoliciesOnSyntheticCasts) {
+    const struct {
+        std::string_view             name;
+        std::vector<Clock::duration> casts;
+    } patterns[] = {{"cloak", CloakCasts()}, {"bolt", BoltCasts()}, {"one-shot", OneShotCasts()}};
+    const struct {
+        std::string_view name;
+        DebouncePolicy   policy;
+    } policies[] = {{"fixed", FIXED}, {"max_latency", MAX_LATENCY}, {"adaptive", ADAPTIVE}};
+
+    for (const auto& pattern : patterns)
+        for (const auto& policy : policies) Print(pattern.name, policy.name, Simulate(policy.policy, pattern.casts));
+}
+
+FORGOTTEN_MAGIC_TEST(FixedWindowWaitsForACloakToStop) {
+    const auto simulation = Simulate(FIXED, CloakCasts());
+    REQUIRE(simulation.updates.size() == 1);
+    CHECK(simulation.updates[0] == 10'500ms);
+    CHECK(simulation.maxStaleness == 10'500ms);
+}
+
+FORGOTTEN_MAGIC_TEST(MaxLatencyUpdatesACloakWhileInUse) {
+    const auto simulation = Simulate(MAX_LATENCY, CloakCasts());
+    const auto whileInUse = std::ranges::count_if(simulation.updates, [](auto at) { return at < 10s; });
+    CHECK(whileInUse == 3);
+    CHECK(simulation.updates.front() == 3s);
+    CHECK(simulation.maxStaleness <= 3s);
+}
+
+FORGOTTEN_MAGIC_TEST(AdaptiveWindowConvergesForBolts) {
+    const auto simulation = Simulate(ADAPTIVE, BoltCasts());
+    REQUIRE(simulation.updates.size() == BoltCasts().size() / 2);
+
+    // One update per cast, starting at the largest window and settling on the 150ms floor
+    CHECK(simulation.updateDelays.front() == 1000ms);
+    CHECK(simulation.updateDelays.back() == 150ms);
+    CHECK(std::ranges::is_sorted(simulation.updateDelays, std::greater<>{}));
+}
+
+FORGOTTEN_MAGIC_TEST(AdaptiveWindowDoesNotSplitACloak) {
+    // Gaps of 500ms keep the window at its 1000ms ceiling, so a cloak is not renamed every cast
+    const auto simulation = Simulate(ADAPTIVE, CloakCasts());
+    CHECK(simulation.updates.size() == 1);
+}
@@ -0,0 +1,42 @@
+// Host tests of the core pipeline, runnable without the game
+//
+// Usage: ForgottenMagicTests [--list] [filter...]
+//
+// Runs every test whose name contains one of the filters (all of them without filters), and
+// exits with 1 if any of them failed.
+
+#include <algorithm>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+
+#include "Test.h"
+
+int main(int argc, char** argv) {
+    auto                          list = false;
+    std::vector<std::string_view> filters;
+    for (int i = 1; i < argc; i++) {
+        std::string_view argument = argv[i];
+        if (argument == "--list") list = true;
+        else filters.push_back(argument);
+    }
+
+    auto failedTests = 0, ranTests = 0;
+    for (const auto& test : ForgottenMagic::Test::Registry()) {
+        const std::string_view name = test.name;
+        if (!filters.empty() && std::ranges::none_of(filters, [name](std::string_view filter) { return name.find(filter) != std::string_view::npos; })) continue;
+        std::printf("%s\n", test.name);
+        if (list) continue;
+
+        ForgottenMagic::Test::failures = 0;
+        test.run();
+        ranTests++;
+        if (ForgottenMagic::Test::failures) {
+            failedTests++;
+            std::printf("    FAILED\n");
+        }
+        std::fflush(stdout);
+    }
+    if (!list) std::printf("%d of %d tests passed\n", ranTests - failedTests, ranTests);
+    return failedTests ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+// NameApplyQueue: the per-frame budget, coalescing of renames, and names arriving while a frame is applying
+
+#include <ForgottenMagic/InMemory.h>
+#include <ForgottenMagic/NameApplyQueue.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+using namespace ForgottenMagic;
+using namespace std::chrono_literals;
+
+namespace {
+    // Sink which takes a fixed time per rename, and records the order spells were renamed in
+    struct SlowNameSink : InMemoryNameSink {
+        NameApplyQueue::Clock::duration renameDuration{};
+        std::vector<SpellHandle>        renamed;
+
+        void SetName(SpellHandle spell, const char* name) override {
+            const auto until = NameApplyQueue::Clock::now() + renameDuration;
+            while (NameApplyQueue::Clock::now() < until) {}
+            InMemoryNameSink::SetName(spell, name);
+            renamed.push_back(spell);
+        }
+    };
+
+    void PostAll(NameApplyQueue& queue, std::size_t spellCount, const char* name) {
+        for (SpellHandle spell = 0; spell < spellCount; spell++) queue.SetName(spell, name);
+    }
+}
+
+FORGOTTEN_MAGIC_TEST(NameApplyQueueAppliesOneNamePerFrameWithoutBudget) {
+    SlowNameSink   sink;
+    NameApplyQueue queue;
+    queue.Configure(8, sink, 0ms);
+    PostAll(queue, 8, "Spell");
+
+    for (std::size_t frame = 1; frame <= 8; frame++) {
+        queue.ApplyPending();
+        CHECK(sink.renameCount == frame);
+        CHECK(queue.PendingCount() == 8 - frame);
+    }
+}
+
+FORGOTTEN_MAGIC_TEST(NameApplyQueueStopsAtTheFrameBudget) {
+    constexpr std::size_t SPELL_COUNT = 20;
+
+    SlowNameSink sink;
+    sink.renameDuration = 1ms;
+    NameApplyQueue queue;
+    queue.Configure(SPELL_COUNT, sink, 2500us);
+    PostAll(queue, SPELL_COUNT, "Spell");
+
+    // Each frame applies at least one name, and stops at the first one which ends past the budget
+    std::size_t frames = 0;
+    while (queue.PendingCount() > 0 && frames < SPELL_COUNT) {
+        const auto before = sink.renameCount;
+        queue.ApplyPending();
+        frames++;
+        CHECK(sink.renameCount - before >= 1);
+        CHECK(sink.renameCount - before <= 3);
+    }
+    CHECK(queue.PendingCount() == 0);
+    CHECK(sink.renameCount == SPELL_COUNT);
+    CHECK(frames >= SPELL_COUNT / 3);
+    CHECK(queue.Frames() == frames);
+}
+
+FORGOTTEN_MAGIC_TEST(NameApplyQueueKeepsOnlyTheLatestNameOfASpell) {
+    SlowNameSink   sink;
+    NameApplyQueue queue;
+    queue.Configure(4, sink, 1s);
+
+    queue.SetName(2, "Flames (10%)");
+    queue.SetName(0, "Frostbite (10%)");
+    queue.SetName(2, "Flames (20%)");
+    queue.SetName(2, "Flames (30%)");
+    CHECK(queue.PendingCount() == 2);
+    CHECK(queue.Coalesced() == 2);
+
+    // Applied once each, with the newest name, in the order the spells were first posted
+    queue.ApplyPending();
+    REQUIRE(sink.renamed.size() == 2);
+    CHECK(sink.renamed[0] == 2);
+    CHECK(sink.renamed[1] == 0);
+    CHECK(sink.names[2] == "Flames (30%)");
+    CHECK(sink.names[0] == "Frostbite (10%)");
+    CHECK(queue.Applied() == 2);
+
+    // A spell renamed after its name was applied is pending again
+    queue.SetName(2, "Flames (40%)");
+    CHECK(queue.PendingCount() == 1);
+    queue.ApplyPending();
+    CHECK(sink.names[2] == "Flames (40%)");
+    CHECK(queue.Coalesced() == 2);
+}
+
+FORGOTTEN_MAGIC_TEST(NameApplyQueueIdleFrameDoesNothing) {
+    SlowNameSink   sink;
+    NameApplyQueue queue;
+    queue.Configure(4, sink, 1s);
+
+    queue.ApplyPending();
+    CHECK(queue.Frames() == 0);
+    CHECK(sink.renameCount == 0);
+
+    queue.SetName(1, "Sparks (50%)");
+    queue.ApplyPending();
+    queue.ApplyPending();
+    CHECK(queue.Frames() == 1);
+    CHECK(sink.renameCount == 1);
+}
+
+FORGOTTEN_MAGIC_TEST(NameApplyQueueEndsTheFrameWhileNamesKeepArriving) {
+    // Names posted while a frame is applying, as by the background thread, wait for a later frame once the budget is spent
+    struct RepostingSink : SlowNameSink {
+        NameApplyQueue* queue = nullptr;
+
+        void SetName(SpellHandle spell, const char* name) override {
+            SlowNameSink::SetName(spell, name);
+            if (spell + 1 < 5) queue->SetName(spell + 1, name);
+        }
+    } sink;
+    sink.renameDuration = 1ms;
+    NameApplyQueue queue;
+    sink.queue = &queue;
+    queue.Configure(5, sink, 0ms);
+    queue.SetName(0, "Spell");
+
+    for (std::size_t frame = 1; frame <= 5; frame++) {
+        queue.ApplyPending();
+        CHECK(sink.renameCount == frame);
+    }
+    CHECK(queue.PendingCount() == 0);
+    CHECK(queue.Frames() == 5);
+}
@@ -0,0 +1,81 @@
+// SpellRegistry: slots by effect FormID through the effect filter's rank, by spell, by book and by spell index
+
+#include <ForgottenMagic/SpellRegistry.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+using namespace ForgottenMagic;
+
+namespace {
+    struct SpellForm {
+        std::uint32_t formID;
+    };
+
+    // Two sources of two spells each, the second source's in a light plugin
+    std::vector<SpellDefinition> Definitions() {
+        return {{1, 7, "Spell Tome: Sparks"}, {0, 3, "Spell Tome: Flames"}, {1, 2, "Spell Tome: Frostbite"}, {0, 9, "Spell Tome: Healing"}};
+    }
+}
+
+FORGOTTEN_MAGIC_TEST(RegistryLaysOutSlotsBySourceThenSpellIndex) {
+    SpellRegistry<SpellForm> registry;
+    registry.Configure(Definitions());
+    REQUIRE(registry.Size() == 4);
+
+    CHECK(registry.FindBySpellIndex(0, 3) == SpellHandle{0});
+    CHECK(registry.FindBySpellIndex(0, 9) == SpellHandle{1});
+    CHECK(registry.FindBySpellIndex(1, 2) == SpellHandle{2});
+    CHECK(registry.FindBySpellIndex(1, 7) == SpellHandle{3});
+    CHECK(!registry.FindBySpellIndex(1, 3));
+    CHECK(registry.SourceSlots(1) == std::pair<SpellHandle, SpellHandle>{2, 4});
+    CHECK(registry.FindByBookName(1, std::string("Spell Tome: Sparks")) == SpellHandle{3});
+    CHECK(!registry.FindByBookName(0, "Spell Tome: Sparks"));
+}
+
+FORGOTTEN_MAGIC_TEST(RegistryFindsSlotsByEffectAndSpell) {
+    SpellRegistry<SpellForm> registry;
+    registry.Configure(Definitions());
+
+    std::vector<SpellForm> forms{{0x2A00'0D62}, {0x2A00'0D63}, {0xFE01'2805}, {0xFE01'2806}};
+    registry.Bind(0, &forms[0], "Flames", std::vector<std::uint32_t>{0x2A00'0900, 0x2A00'0A41});
+    registry.Bind(1, &forms[1], "Healing", std::vector<std::uint32_t>{0x2A00'0902});
+    registry.Bind(3, &forms[3], "Sparks", std::vector<std::uint32_t>{0xFE01'2801, 0x2A00'0900});
+    registry.FinishBinding();
+
+    CHECK(registry.FindByEffectFormID(0x2A00'0A41) == SpellHandle{0});
+    CHECK(registry.FindByEffectFormID(0x2A00'0902) == SpellHandle{1});
+    CHECK(registry.FindByEffectFormID(0xFE01'2801) == SpellHandle{3});
+
+    // An effect shared by two spells finds the first one bound
+    CHECK(registry.FindByEffectFormID(0x2A00'0900) == SpellHandle{0});
+
+    // Untracked effects, including ones inside a tracked range or from the same plugin
+    CHECK(!registry.FindByEffectFormID(0x2A00'0901));
+    CHECK(!registry.FindByEffectFormID(0x2A00'0800));
+    CHECK(!registry.FindByEffectFormID(0x2B00'0900));
+    CHECK(!registry.FindByEffectFormID(0xFE02'2801));
+    CHECK(registry.EffectFormIDs().size() == 4);
+
+    CHECK(registry.FindBySpell(&forms[1]) == SpellHandle{1});
+    CHECK(registry.FindBySpell(&forms[3]) == SpellHandle{3});
+    CHECK(!registry.FindBySpell(&forms[2]));
+    CHECK(registry.originalNames[3] == "Sparks");
+}
+
+FORGOTTEN_MAGIC_TEST(EffectFilterRanksTrackedFormIDsInOrder) {
+    const std::vector<std::uint32_t> tracked{0xFE01'2801, 0x0500'0100, 0x2A00'0900, 0x2A00'0A41, 0x0500'0100, 0x2A00'0902};
+    EffectFilter                     filter;
+    filter.Build(tracked);
+
+    CHECK(filter.Rank(0x0500'0100) == 0u);
+    CHECK(filter.Rank(0x2A00'0900) == 1u);
+    CHECK(filter.Rank(0x2A00'0902) == 2u);
+    CHECK(filter.Rank(0x2A00'0A41) == 3u);
+    CHECK(filter.Rank(0xFE01'2801) == 4u);
+    CHECK(!filter.Rank(0x2A00'0901));
+    for (const auto formID : tracked) CHECK(filter.Contains(formID));
+}
@@ -0,0 +1,70 @@
+// RenderedNames: the co-save record round-trips, and damaged or foreign records are rejected
+
+#include <ForgottenMagic/RenderedNames.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "Test.h"
+
+using namespace ForgottenMagic;
+
+namespace {
+    std::vector<RenderedNames::Source> SampleSources() {
+        return {
+            {"ForgottenMagic", {{0, 2, 50, 0}, {7, 0, 100, 0}, {40, 3, 0, 0}}},
+            {"NoSpellsShown", {}},
+            {"Other", {{3, 65535, 1, 0}}},
+        };
+    }
+}
+
+FORGOTTEN_MAGIC_TEST(RenderedNamesRoundTrip) {
+    const auto sources = SampleSources();
+    const auto bytes   = RenderedNames::Encode(sources);
+    const auto decoded = RenderedNames::Decode(bytes, RenderedNames::VERSION);
+    REQUIRE(decoded.has_value());
+    REQUIRE(decoded->size() == sources.size());
+    for (std::size_t i = 0; i < sources.size(); i++) {
+        CHECK((*decoded)[i].name == sources[i].name);
+        REQUIRE((*decoded)[i].entries.size() == sources[i].entries.size());
+        for (std::size_t j = 0; j < sources[i].entries.size(); j++) {
+            const auto& entry    = (*decoded)[i].entries[j];
+            const auto& expected = sources[i].entries[j];
+            CHECK(entry.spellIndex == expected.spellIndex);
+            CHECK(entry.points == expected.points);
+            CHECK(entry.progress == expected.progress);
+        }
+    }
+}
+
+FORGOTTEN_MAGIC_TEST(RenderedNamesRoundTripWithoutSources) {
+    const auto decoded = RenderedNames::Decode(RenderedNames::Encode({}), RenderedNames::VERSION);
+    REQUIRE(decoded.has_value());
+    CHECK(decoded->empty());
+}
+
+FORGOTTEN_MAGIC_TEST(RenderedNamesRejectsTruncatedRecords) {
+    const auto bytes = RenderedNames::Encode(SampleSources());
+    for (std::size_t size = 0; size < bytes.size(); size++) CHECK(!RenderedNames::Decode(std::span(bytes.data(), size), RenderedNames::VERSION));
+}
+
+FORGOTTEN_MAGIC_TEST(RenderedNamesRejectsOtherVersions) {
+    const auto bytes = RenderedNames::Encode(SampleSources());
+    CHECK(!RenderedNames::Decode(bytes, 0));
+    CHECK(!RenderedNames::Decode(bytes, RenderedNames::VERSION + 1));
+}
+
+FORGOTTEN_MAGIC_TEST(RenderedNamesRejectsCountsPastTheEnd) {
+    // A damaged record claiming far more sources, name bytes or entries than it holds
+    const auto bytes = RenderedNames::Encode(SampleSources());
+    for (const std::size_t offset : {std::size_t{0}, sizeof(std::uint32_t), 2 * sizeof(std::uint32_t) + 14}) {
+        auto                damaged = bytes;
+        const std::uint32_t huge    = 0xFFFF'FFF0;
+        std::memcpy(damaged.data() + offset, &huge, sizeof(huge));
+        CHECK(!RenderedNames::Decode(damaged, RenderedNames::VERSION));
+    }
+}
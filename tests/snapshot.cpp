@@ -0,0 +1,77 @@
+// XpSnapshot and SpellNameUpdater: a batch which captures only its own spell indexes sees the same values as a full capture
+
+#include <ForgottenMagic/InMemory.h>
+#include <ForgottenMagic/SpellNameUpdater.h>
+#include <ForgottenMagic/XpSnapshot.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Test.h"
+
+using namespace ForgottenMagic;
+
+FORGOTTEN_MAGIC_TEST(PartialCaptureMatchesFullCapture) {
+    InMemoryXpSource source;
+    source.entries = {{10.0f, 100.0f, 1}, {50.0f, 100.0f, 0}, {-1.0f, 100.0f, 0}, {25.0f, 0.0f, 2}, {99.0f, 100.0f, 3}};
+
+    XpSnapshot full;
+    source.Capture(full);
+    full.ComputeProgress();
+
+    // Indexes past the source's entries stay out of bounds
+    const std::vector<SpellIndex> batch = {4, 1, 2, 3, 7};
+    XpSnapshot                    partial;
+    source.Capture(partial, batch);
+    partial.ComputeProgress(batch);
+
+    for (const auto spellIndex : batch) {
+        CHECK(partial.Invalid(spellIndex) == full.Invalid(spellIndex));
+        if (!full.Invalid(spellIndex)) {
+            CHECK(partial.Progress(spellIndex) == full.Progress(spellIndex));
+            CHECK(partial.Points(spellIndex) == full.Points(spellIndex));
+        }
+    }
+    CHECK(partial.Invalid(7) == XpSnapshot::OUT_OF_ARRAY_BOUNDS);
+}
+
+FORGOTTEN_MAGIC_TEST(PartialCaptureResetsReusedLanes) {
+    InMemoryXpSource source;
+    source.entries = {{10.0f, 100.0f, 1}, {50.0f, 100.0f, 0}};
+
+    XpSnapshot                    snapshot;
+    const std::vector<SpellIndex> batch = {1};
+    source.Capture(snapshot, batch);
+    snapshot.ComputeProgress(batch);
+    CHECK(snapshot.Progress(1) == 50);
+
+    // The same lane, now invalid at the source, is not left with the previous batch's values
+    source.entries[1].xpReq = 0.0f;
+    source.Capture(snapshot, batch);
+    snapshot.ComputeProgress(batch);
+    CHECK(snapshot.Invalid(1) == XpSnapshot::XP_REQ_NOT_POSITIVE);
+    CHECK(snapshot.Progress(1) == 0);
+}
+
+FORGOTTEN_MAGIC_TEST(UpdaterRenamesOnlyTheBatch) {
+    constexpr std::size_t SPELL_COUNT = 4;
+
+    std::vector<SpellIndex>        spellIndexes = {3, 2, 1, 0};
+    std::vector<std::string>       originalNames(SPELL_COUNT, "Flames");
+    std::vector<SpellNameRenderer> nameRenderers(SPELL_COUNT);
+    InMemoryXpSource               source;
+    source.entries.assign(SPELL_COUNT, {40.0f, 100.0f, 1});
+    InMemoryNameSink names;
+
+    SpellNameUpdater               updater;
+    const std::vector<SpellHandle> batch  = {1, 3};
+    const auto                     result = updater.Update(batch, {spellIndexes, originalNames, nameRenderers}, source, names);
+    CHECK(result.captured);
+    CHECK(result.renamesIssued == 2);
+    CHECK(names.renameCount == 2);
+    REQUIRE(names.names.size() == SPELL_COUNT);
+    CHECK(names.names[0].empty());
+    CHECK(!names.names[1].empty());
+    CHECK(names.names[1] == names.names[3]);
+}
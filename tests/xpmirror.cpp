@@ -0,0 +1,70 @@
+// XpMirror: predicting XP per cast from the effect events the game reports
+
+#include <ForgottenMagic/InMemory.h>
+#include <ForgottenMagic/XpMirror.h>
+#include <ForgottenMagic/XpSnapshot.h>
+
+#include <chrono>
+
+#include "Test.h"
+
+using namespace ForgottenMagic;
+using namespace std::chrono_literals;
+
+namespace {
+    // A mirror seeded from a source with two spell indexes at 10 of 100 XP
+    void Seed(XpMirror& mirror) {
+        InMemoryXpSource source;
+        source.entries.assign(2, {10.0f, 100.0f, 0});
+        XpSnapshot snapshot;
+        source.Capture(snapshot);
+        mirror.Reconcile(snapshot);
+        mirror.SetCastWindow(250ms);
+    }
+
+    float PredictedXp(XpMirror& mirror, SpellIndex spellIndex) {
+        XpSnapshot snapshot;
+        mirror.Capture(snapshot);
+        return snapshot.Xp(spellIndex);
+    }
+}
+
+FORGOTTEN_MAGIC_TEST(XpMirrorCountsAMultiEffectCastOnce) {
+    XpMirror mirror;
+    Seed(mirror);
+    const auto castAt = XpMirror::Clock::time_point{} + 1h;
+
+    // A bolt with two effects, hitting three targets
+    CHECK(mirror.RecordEffect(0, 1.0f, castAt));
+    for (auto target = 0; target < 3; target++) {
+        CHECK(!mirror.RecordEffect(0, 1.0f, castAt));
+        CHECK(!mirror.RecordEffect(0, 1.0f, castAt + 10ms));
+    }
+    CHECK(PredictedXp(mirror, 0) == 11.0f);
+
+    // Cast again once the window has passed; the other spell index is tracked separately
+    CHECK(mirror.RecordEffect(0, 1.0f, castAt + 400ms));
+    CHECK(mirror.RecordEffect(1, 1.0f, castAt + 400ms));
+    CHECK(PredictedXp(mirror, 0) == 12.0f);
+    CHECK(PredictedXp(mirror, 1) == 11.0f);
+}
+
+FORGOTTEN_MAGIC_TEST(XpMirrorCountsAContinuousStreamOfEffectsOnce) {
+    XpMirror mirror;
+    Seed(mirror);
+    const auto startedAt = XpMirror::Clock::time_point{} + 1h;
+
+    // A concentration spell applying its effect every 100ms for 2s
+    for (auto at = 0ms; at < 2s; at += 100ms) mirror.RecordEffect(0, 1.0f, startedAt + at);
+    CHECK(PredictedXp(mirror, 0) == 11.0f);
+}
+
+FORGOTTEN_MAGIC_TEST(XpMirrorIgnoresEffectsUntilSeeded) {
+    XpMirror mirror;
+    mirror.SetCastWindow(250ms);
+    CHECK(!mirror.RecordEffect(0, 1.0f, XpMirror::Clock::time_point{} + 1h));
+
+    Seed(mirror);
+    mirror.Reset();
+    CHECK(!mirror.RecordEffect(0, 1.0f, XpMirror::Clock::time_point{} + 2h));
+}
@@ -0,0 +1,234 @@
+// Replays a capture written by the plugin's [Capture] mode through the same filtering,
+// debounce and batching pipeline, outside the game
+//
+// Usage: ForgottenMagicReplay <capture file> [--speed N] [--quiet-ms N] [--max-latency-ms N]
+//
+//   --speed N           Replay N times faster than the events were captured (default 1);
+//                       0 replays as fast as possible, to measure the event path alone
+//   --quiet-ms N        Debounce quiet period, in captured time (default 1000)
+//   --max-latency-ms N  Debounce max latency, in captured time (default none)
+//
+// Prints the event path's throughput, then the metrics summary as JSON. Latencies are
+// reported in captured time, so they are comparable between replay speeds.
+
+#include <ForgottenMagic/DebounceScheduler.h>
+#include <ForgottenMagic/EffectFilter.h>
+#include <ForgottenMagic/EventCapture.h>
+#include <ForgottenMagic/InMemory.h>
+#include <ForgottenMagic/Metrics.h>
+#include <ForgottenMagic/SpellNameRenderer.h>
+#include <ForgottenMagic/SpellNameUpdater.h>
+#include <ForgottenMagic/SpellUseInbox.h>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace ForgottenMagic;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string     capturePath;
+        double          speed{1.0};
+        Clock::duration quietPeriod{std::chrono::milliseconds(1000)};
+        Clock::duration maxLatency{};
+    };
+
+    template <typename T>
+    bool ParseNumber(std::string_view text, T& value) {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc{} && end == text.data() + text.size();
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+            if (!argument.starts_with("--")) {
+                options.capturePath = argument;
+                continue;
+            }
+            if (i + 1 >= argc) return false;
+            std::string_view value = argv[++i];
+
+            double number;
+            if (!ParseNumber(value, number) || number < 0) return false;
+            const auto milliseconds = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(number));
+            if (argument == "--speed") options.speed = number;
+            else if (argument == "--quiet-ms") options.quietPeriod = milliseconds;
+            else if (argument == "--max-latency-ms") options.maxLatency = milliseconds;
+            else return false;
+        }
+        return !options.capturePath.empty();
+    }
+
+    // Converts captured time to replay time and back
+    struct TimeScale {
+        double speed;
+
+        Clock::duration ToReplay(Clock::duration captured) const { return speed > 0 ? std::chrono::duration_cast<Clock::duration>(captured / speed) : captured; }
+        Clock::duration ToCaptured(Clock::duration replayed) const { return speed > 0 ? std::chrono::duration_cast<Clock::duration>(replayed * speed) : replayed; }
+    };
+
+    // Name sink which counts renames in the metrics before recording them
+    class CountingNameSink : public INameSink {
+        Metrics&          metrics;
+        InMemoryNameSink& names;
+
+    public:
+        CountingNameSink(Metrics& metrics, InMemoryNameSink& names) : metrics(metrics), names(names) {}
+
+        void SetName(SpellHandle spell, const char* name) override {
+            metrics.CountRename(spell);
+            names.SetName(spell, name);
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "Usage: ForgottenMagicReplay <capture file> [--speed N] [--quiet-ms N] [--max-latency-ms N]\n";
+        return 2;
+    }
+
+    auto capture = EventCapture::Load(options.capturePath);
+    if (!capture) {
+        std::cerr << "Could not read capture " << options.capturePath << "\n";
+        return 1;
+    }
+
+    // Effect filter and effect -> spell lookup, as built by the plugin
+    std::ranges::sort(capture->effects, {}, &EventCapture::Effect::effectFormID);
+    std::vector<std::uint32_t> effectFormIDs;
+    SpellHandle                spellCount = 0;
+    for (const auto& effect : capture->effects) {
+        effectFormIDs.push_back(effect.effectFormID);
+        spellCount = std::max(spellCount, effect.spell + 1);
+    }
+    EffectFilter filter;
+    filter.Build(effectFormIDs);
+
+    // Records from different event threads may have been appended slightly out of order
+    std::ranges::stable_sort(capture->records, {}, &EventCapture::Record::timestampNs);
+
+    // Every spell uses its handle as its spell index and earns 1 XP per cast, so that batches produce renames
+    std::vector<SpellIndex>        spellIndexes(spellCount);
+    std::vector<std::string>       originalNames(spellCount);
+    std::vector<SpellNameRenderer> nameRenderers(spellCount);
+    InMemoryXpSource               xpSource;
+    xpSource.entries.assign(spellCount, {0.0f, 100.0f, 0});
+    for (SpellHandle spell = 0; spell < spellCount; spell++) {
+        spellIndexes[spell]  = spell;
+        originalNames[spell] = "Spell " + std::to_string(spell);
+        nameRenderers[spell].Reserve(originalNames[spell]);
+    }
+    const SpellNameColumns columns{spellIndexes, originalNames, nameRenderers};
+
+    const TimeScale timeScale{options.speed};
+    const auto      policy = options.maxLatency > Clock::duration::zero()
+                                 ? DebouncePolicy::MaxLatency(timeScale.ToReplay(options.quietPeriod), timeScale.ToReplay(options.maxLatency))
+                                 : DebouncePolicy::Fixed(timeScale.ToReplay(options.quietPeriod));
+
+    Metrics metrics;
+    metrics.Configure(true, spellCount);
+
+    SpellUseInbox     inbox;
+    DebounceScheduler scheduler(policy.quietPeriod);
+    inbox.Resize(spellCount);
+    scheduler.Resize(spellCount);
+    for (SpellHandle spell = 0; spell < spellCount; spell++) scheduler.SetPolicy(spell, policy);
+
+    std::mutex              mutex;
+    std::condition_variable cv;
+    std::atomic<bool>       producerFinished{false};
+
+    // Consumer: the plugin's background thread loop
+    InMemoryNameSink names;
+    CountingNameSink sink(metrics, names);
+    std::thread      consumer([&] {
+        SpellNameUpdater         updater;
+        std::vector<SpellHandle> due;
+        auto                     finishing = false;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                const auto                   sleepUntil = scheduler.Empty() ? Clock::time_point::max() : scheduler.NextDeadline();
+                if (inbox.BeginSleep(sleepUntil)) {
+                    auto woken = [&] { return !inbox.IsSleeping() || (producerFinished && !finishing); };
+                    if (sleepUntil == Clock::time_point::max()) cv.wait(lock, woken);
+                    else cv.wait_until(lock, sleepUntil, woken);
+                }
+                inbox.EndSleep();
+                finishing = producerFinished;
+            }
+
+            inbox.Drain([&](SpellHandle spell, Clock::time_point usedAt) {
+                scheduler.Schedule(spell, usedAt);
+                xpSource.entries[spell].xp = std::min(xpSource.entries[spell].xp + 1.0f, xpSource.entries[spell].xpReq);
+            });
+
+            const auto now = Clock::now();
+            due.clear();
+            scheduler.PopDue(now, due);
+            for (auto spell : due) metrics.RecordPickup(spell, timeScale.ToCaptured(now - scheduler.LastUse(spell)));
+
+            if (!due.empty()) {
+                updater.Update(due, columns, xpSource, sink);
+                metrics.Count(Metrics::BATCHES);
+                metrics.Record(Metrics::BATCH_DURATION, Clock::now() - now);
+            }
+
+            if (finishing && scheduler.Empty()) break;
+        }
+    });
+
+    // Producer: the plugin's event handler, fed at the captured pace
+    Clock::duration eventPathTime{};
+    const auto      startedAt = Clock::now();
+    for (const auto& record : capture->records) {
+        if (options.speed > 0) std::this_thread::sleep_until(startedAt + timeScale.ToReplay(std::chrono::nanoseconds(record.timestampNs)));
+
+        const auto eventStartedAt = Clock::now();
+        metrics.Count(Metrics::EVENTS_SEEN);
+        if (filter.Contains(record.effectFormID)) {
+            const auto effect = std::ranges::lower_bound(capture->effects, record.effectFormID, {}, &EventCapture::Effect::effectFormID);
+            if (effect != capture->effects.end() && effect->effectFormID == record.effectFormID) {
+                metrics.CountEvent(effect->spell);
+                const auto now = Clock::now();
+                if (inbox.Record(effect->spell, now, now + scheduler.MinimumDelay(effect->spell))) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    cv.notify_one();
+                }
+            }
+        }
+        eventPathTime += Clock::now() - eventStartedAt;
+    }
+    const auto replayTime = Clock::now() - startedAt;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        producerFinished = true;
+    }
+    cv.notify_one();
+    consumer.join();
+
+    const auto eventCount = std::max<std::size_t>(capture->records.size(), 1);
+    const auto seconds    = std::chrono::duration<double>(replayTime).count();
+    std::cerr << "Replayed " << capture->records.size() << " events (" << capture->effects.size() << " tracked effects, " << spellCount << " spells) in " << seconds << "s at speed "
+              << options.speed << "\n";
+    std::cerr << "Event path: " << std::chrono::duration<double, std::nano>(eventPathTime).count() / static_cast<double>(eventCount) << "ns per event, "
+              << static_cast<double>(capture->records.size()) / std::max(std::chrono::duration<double>(eventPathTime).count(), 1e-9) << " events/s\n";
+    metrics.WriteJson(std::cout);
+    return 0;
+}
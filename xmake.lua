@@ -2,10 +2,64 @@ add_rules("mode.debug", "mode.release")
 
 set_languages("c++23")
 
+-- Debug and trace log messages are compiled out of release builds
+if is_mode("release") then
+    add_defines("FORGOTTEN_MAGIC_MIN_LOG_LEVEL=2")
+end
+
 option("commonlib")
     set_default("skyrim-commonlib-ng")
 option_end()
 
+-- Path to pyro.exe, which compiles the Papyrus scripts (papyrus.ppj) before the plugin is built
+option("pyro")
+    set_showmenu(true)
+    set_description("Path to the Pyro Papyrus build tool, to compile Scripts/Source into Scripts/*.pex")
+option_end()
+
+-- AsyncLog formats with std::format; standard libraries without <format> (such as g++ 12's) need fmt instead
+option("fmt")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Format log messages with the fmt library, for toolchains whose standard library has no <format>")
+option_end()
+
+if has_config("fmt") then
+    add_requires("fmt")
+end
+
+-- Game-agnostic debounce / XP / naming pipeline, buildable without CommonLib (xmake f --commonlib=)
+target("ForgottenMagicCore")
+    set_kind("headeronly")
+    add_headerfiles("core/(ForgottenMagic/*.h)")
+    add_includedirs("core", { public = true })
+    if has_config("fmt") then
+        add_packages("fmt", { public = true })
+        add_defines("FORGOTTEN_MAGIC_USE_FMT", { public = true })
+    end
+
+-- Replays a capture recorded by the plugin's [Capture] mode through the core pipeline (xmake run ForgottenMagicReplay <file>)
+target("ForgottenMagicReplay")
+    set_kind("binary")
+    add_files("tools/replay.cpp")
+    add_deps("ForgottenMagicCore")
+
+-- Host benchmarks of the core pipeline, runnable on plain Linux (xmake run ForgottenMagicBench [filter...])
+target("ForgottenMagicBench")
+    set_kind("binary")
+    add_files("bench/*.cpp")
+    add_deps("ForgottenMagicCore")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+-- Host tests of the core pipeline (xmake test, or xmake run ForgottenMagicTests [filter...])
+target("ForgottenMagicTests")
+    set_kind("binary")
+    add_files("tests/*.cpp")
+    add_deps("ForgottenMagicCore")
+    add_tests("default")
+
 if not has_config("commonlib") then
     return
 end
@@ -30,5 +84,7 @@ skse_plugin({
     author = "Mrowr Purr",
     email = "mrowr.purr@gmail.com",
     packages = {"SkyrimScripting.Plugin", "unordered_dense", "collections", "simpleini"},
-    mod_files = {"SKSE"}
+    deps = {"ForgottenMagicCore"},
+    mod_files = {"SKSE", "Scripts"},
+    papyrus_project = "papyrus.ppj"
 })
@@ -27,4 +27,17 @@ function skse_plugin(plugin_info)
         for _, dependency in ipairs(plugin_info.deps or {}) do
             add_deps(dependency)
         end
+        if plugin_info.papyrus_project then
+            -- Compile the scripts into the Scripts folder first, so the .pex files are deployed with mod_files
+            set_values("papyrus_project", plugin_info.papyrus_project)
+            before_build(function (target)
+                local project = path.join(os.projectdir(), target:values("papyrus_project"))
+                local pyro = get_config("pyro")
+                if pyro then
+                    os.execv(pyro, {"--input-path", project})
+                else
+                    cprint("${yellow}Papyrus scripts were not compiled: configure Pyro with xmake f --pyro=<path to pyro.exe>")
+                end
+            end)
+        end
 end